@@ -1,3 +1,6 @@
+#ifndef PDSTSP_ACO_SOLUTION
+#define PDSTSP_ACO_SOLUTION
+
 #include "paper/utilities.cpp"
 #include "paper/NNTourBuilder.cpp"
 
@@ -5,41 +8,139 @@
 #include "problem.cpp"
 #include "local_search_optimize.cpp"
 #include "dynamic_programming_split_tour.cpp"
-
+#include "convergence_trace.cpp"
+#include "logger.cpp"
+#include "checkpoint.cpp"
+#include "exact_solver.cpp"
+#include "thread_clock.cpp"
+#include "lower_bound.cpp"
+#include "stagnation.cpp"
+#include "adaptive_control.cpp"
+#include "memo_cache.cpp"
+
+/*
+ * The colony. solve() keeps its whole state on the stack and in the calling thread's
+ * Rng::solver, so solves on different threads do not interfere. process() is the
+ * winter_main entry point: it adds the checkpoint, the trace and the result printing.
+ */
 namespace ACO_solution {
     #ifndef ORE_INFINITY
     #define ORE_INFINITY 1e9+7
     #endif
 
-    double maxPhe, minPhe, tLimit, rho, best_time, best_loop, tsp_rho;
-    int nAnts, iLimit, num_drone_keeping, percent_drone_keeping;
+    const int GRANULAR_WINDOW = 5; /// idle loops before the granular filter doubles
+
+    /// settings that do not depend on the instance, winter_main fills them from the command line
+    struct Options {
+        int exact_limit = Exact_Solver::MAX_CUSTOMERS; /// instances with at most this many customers are solved by Exact_Solver
+        double gap = 0; /// stop once (best - lower bound) / lower bound is at most gap
+        int stagnation_stop = 0; /// stop after this many loops without improvement, 0: never
+        int restart = 0; /// reset the pheromone after this many loops without improvement, 0: never
+        double restart_branching = 2.5; /// ... if the branching factor of tsp_phe is at most this
+        bool adaptive = false; /// nAnts, rho, tsp_rho and percent_drone_keeping are tuned online by Adaptive_Control
+        double memo_cache = 0; /// MB of Memo_Cache for the 3-opt tours of repeated vehicle sets, 0: no cache
+        bool pms_improve = false; /// MULTIFIT after LPT in pms_optimizer
+        int granular = 0; /// k of the granular vehicle <-> drone swaps in local_search::descend, 0: every swap
+    };
+
+    struct Parameters : Options {
+        double maxPhe, minPhe, tLimit, rho, tsp_rho;
+        int nAnts, iLimit, percent_drone_keeping;
+    };
+
+    /// incumbent installed at the start of the solve
+    struct Initial_Solution {
+        bool enabled = false;
+        double bias = 0.5; /// 0: uniform pheromone, 1: pheromone fully on the initial solution
+        tigersugar::Tour vehicle;
+        tigersugar::Drone_Tour drone;
+    };
+
+    struct Result {
+        double cost = -1;
+        tigersugar::Tour vehicle;
+        tigersugar::Drone_Tour drone;
+        double best_time = 0, elapsed = 0;
+        int best_loop = 0, num_loop = 0;
+        double lower_bound = 0;
+        bool optimal = false; /// certified by Exact_Solver or by the lower bound
+        int restarts = 0;
+        string stop = "loops"; /// loops, time, gap, stagnation or exact
+        Memo_Cache::Stats memo;
+    };
+
+    /// everything a solve reads besides the instance
+    struct Context {
+        Parameters param;
+        const Initial_Solution *initial = NULL;
+        Convergence_Trace::Writer *trace = NULL;
+        bool checkpoint = false; /// restore and save the colony through the Checkpoint globals
+        bool verbose = false; /// print the progress of every loop to stdout
+    };
+
+    /// warm start of winter_main
+    Initial_Solution initial;
+
+    void set_initial_solution(const tigersugar::Tour &vehicle, const tigersugar::Drone_Tour &drone, double bias) {
+        initial.enabled = true;
+        initial.vehicle = vehicle;
+        initial.drone = drone;
+        initial.bias = bias;
+    }
 
-    void Assign_Parameter(tigersugar::Instance &instance) {
-        rho = 0.9;
-        tsp_rho = 0.9;
-        maxPhe = 1.0;
-        minPhe = maxPhe / (double) (2*instance.numPoint);
-        
-        nAnts = instance.numPoint;
-        iLimit = 10000;
-        tLimit = instance.time_limit;
-        percent_drone_keeping = 50;
-
-        cerr<<"rho                  "<<rho<<"\n";
-        cerr<<"tsp_rho              "<<tsp_rho<<"\n";
-        cerr<<"nAnts                "<<nAnts<<"\n";
-        cerr<<"iLimit               "<<iLimit<<"\n";
-        cerr<<"tLimit               "<<tLimit<<"\n";
-
-        cout<<"rho                  "<<rho<<"\n";
-        cout<<"tsp_rho              "<<tsp_rho<<"\n";
-        cout<<"nAnts                "<<nAnts<<"\n";
-        cout<<"iLimit               "<<iLimit<<"\n";
-        cout<<"tLimit               "<<tLimit<<"\n";
+    Options options;
+
+    /// CPU time of the calling thread, concurrent solves do not eat each other's time limit
+    using Thread_Clock::cpu_time;
+
+    Parameters default_parameters(const tigersugar::Instance &instance) {
+        Parameters param;
+        (Options &) param = options;
+        param.rho = 0.9;
+        param.tsp_rho = 0.9;
+        param.maxPhe = 1.0;
+        param.minPhe = param.maxPhe / (double) (2*instance.numPoint);
+
+        param.nAnts = instance.numPoint;
+        param.iLimit = instance.loop_limit;
+        param.tLimit = instance.time_limit;
+        param.percent_drone_keeping = 50;
+        return param;
     }
 
-    void process(tigersugar::Instance &instance) {
-    	Assign_Parameter(instance);
+    Result solve(tigersugar::Instance &instance, const Context &context) {
+        const Parameters &param = context.param;
+        const double maxPhe = param.maxPhe, minPhe = param.minPhe;
+        double rho = param.rho, tsp_rho = param.tsp_rho;
+        int nAnts = param.nAnts, percent_drone_keeping = param.percent_drone_keeping;
+        int granular = min(param.granular, tigersugar::NUM_NEIGHBOURS);
+        Adaptive_Control::Controller controller(param.nAnts, param.rho, param.tsp_rho);
+        double best_time = 0;
+        int best_loop = 0, num_drone_keeping;
+
+        /// small instance: no colony, the optimum is computed directly
+        Exact_Solver::Solution exact;
+        double exact_time = 0; /// spent by a failed exact solve, charged to the colony's time limit
+        if (!(context.checkpoint && Checkpoint::pending) && instance.numPoint <= param.exact_limit) {
+            double start = cpu_time();
+            if (Exact_Solver::solve(instance, exact, param.exact_limit, param.tLimit)) {
+                Result result;
+                result.cost = result.lower_bound = exact.cost;
+                result.vehicle = exact.vehicle;
+                result.drone = exact.drone;
+                result.elapsed = result.best_time = cpu_time() - start;
+                result.optimal = true;
+                result.stop = "exact";
+                if (context.trace != NULL) {
+                    context.trace->record(result.elapsed, 0, exact.vehicle.distance(instance), exact.drone.distance(instance),
+                                          exact.vehicle.distance(instance), exact.drone.distance(instance));
+                }
+                LOG_INFO("Optimal solution " << result.cost << " found by the exact solver");
+                return result;
+            }
+            exact_time = cpu_time() - start;
+            LOG_INFO("Exact solver gave up after " << exact_time << "s, running the colony");
+        }
 
         /// create phe array
         vector<double> phe;
@@ -56,14 +157,89 @@ namespace ACO_solution {
         tigersugar::Drone_Tour best_drone;
         double best_vehicle_cost = ORE_INFINITY+1, best_drone_cost = ORE_INFINITY+1;
 
-        clock_t startTime = clock();
-        int numOutLoop = 0;
-        FOR(loop, 1, iLimit) {
-            if ((double)(clock() - startTime) / CLOCKS_PER_SEC > tLimit) break;
+        /// start from the initial solution, the pheromone is biased toward it
+        if (context.initial != NULL && context.initial->enabled) {
+            const Initial_Solution &initial = *context.initial;
+            best_vehicle = initial.vehicle;
+            best_drone = initial.drone;
+            best_vehicle_cost = best_vehicle.distance(instance);
+            best_drone_cost = best_drone.distance(instance);
+            best_time = 0;
+            best_loop = 0;
+
+            double biased = maxPhe * (1 - initial.bias) + minPhe * initial.bias;
+            for (int x : best_vehicle.points) if (phe[x] > 0) phe[x] = biased;
+            FOR(u, 0, instance.numPoint) FOR(v, 0, instance.numPoint) tsp_phe[u][v] = biased;
+            FOR(i, 0, (int) best_vehicle.points.size()-2) {
+                int u = best_vehicle.points[i], v = best_vehicle.points[i+1];
+                tsp_phe[u][v] = tsp_phe[v][u] = maxPhe;
+            }
+            LOG_INFO("Start from the initial solution " << max(best_vehicle_cost, best_drone_cost));
+        }
+
+        /// continue an interrupted run
+        int first_loop = 1;
+        int restarts = 0, last_restart = 0;
+        double resumed_time = 0;
+        if (context.checkpoint && Checkpoint::pending) {
+            Checkpoint::Colony &colony = Checkpoint::colony;
+            phe = colony.phe;
+            tsp_phe = colony.tsp_phe;
+            best_vehicle = colony.best_vehicle;
+            best_drone = colony.best_drone;
+            best_vehicle_cost = colony.best_vehicle_cost;
+            best_drone_cost = colony.best_drone_cost;
+            best_time = colony.best_time;
+            best_loop = colony.best_loop;
+            restarts = colony.restarts;
+            last_restart = colony.last_restart;
+            nAnts = colony.nAnts;
+            percent_drone_keeping = colony.percent_drone_keeping;
+            rho = colony.rho;
+            tsp_rho = colony.tsp_rho;
+            controller = colony.controller;
+            granular = colony.granular;
+            memcpy(Rng::solver.s, colony.rng, sizeof(colony.rng));
+
+            first_loop = colony.loop + 1;
+            resumed_time = colony.elapsed;
+            Checkpoint::pending = false;
+            LOG_INFO("Resume run #" << Checkpoint::run << " at loop " << first_loop << " after " << resumed_time << "s");
+        }
+
+        double startTime = cpu_time() - resumed_time - exact_time;
+        double lastCheckpoint = cpu_time();
+
+        /// the colony stops as soon as the incumbent is within the gap of the bound
+        double lower_bound = Lower_Bound::makespan(instance);
+        double stop_cost = lower_bound * (1 + max(0.0, param.gap) + 1e-9) + 1e-6;
+        LOG_INFO("Lower bound " << lower_bound << " computed in " << cpu_time() - startTime - resumed_time - exact_time << "s");
+
+        string stop = "loops";
+        Stagnation::Edge_Set incumbent_edges;
+
+        /// per-ant solutions, reused across ants and loops: the best ant of a loop is swapped in, not copied
+        vector<pair<double, int> > drone_keeping;
+        tigersugar::Tour vehicle, best_inLoop_vehicle;
+        tigersugar::Drone_Tour drone, best_inLoop_drone;
+
+        unique_ptr<Memo_Cache::Cache> memo;
+        uint64_t all_customers = 0;
+        if (param.memo_cache > 0) {
+            memo.reset(new Memo_Cache::Cache((size_t) (param.memo_cache * 1024 * 1024)));
+            FOR(x, 1, instance.numPoint) all_customers ^= Rng::zobrist(x);
+        }
+
+        int numOutLoop = first_loop - 1;
+        FOR(loop, first_loop, param.iLimit) {
+            if (cpu_time() - startTime > param.tLimit) { stop = "time"; break; }
+            if (max(best_vehicle_cost, best_drone_cost) <= stop_cost) {
+                LOG_INFO("Gap to the lower bound reached at loop " << loop);
+                stop = "gap";
+                break;
+            }
             ++numOutLoop;
 
-            tigersugar::Tour best_inLoop_vehicle;
-            tigersugar::Drone_Tour best_inLoop_drone;
             double best_inLoop_vehicle_cost, best_inLoop_drone_cost;
 
             if (best_vehicle_cost < ORE_INFINITY) {
@@ -72,15 +248,17 @@ namespace ACO_solution {
            	else {
            		num_drone_keeping = 0;
            	}
+            incumbent_edges.assign(best_vehicle, instance.numPoint);
+            double loopStart = cpu_time(), previous_best = max(best_vehicle_cost, best_drone_cost);
+            double diversity = 0;
             
             FOR(ant, 1, nAnts) {
-                /// build always drone
-                vector<pair<double, int> > drone_keeping;
+                /// build always drone, each eligible customer is kept with probability (percent_drone_keeping+1)%
+                drone_keeping.clear();
+                Rng::Bernoulli_Batch keep(Rng::solver, (percent_drone_keeping + 1) / 100.0);
                 FOR(x, 1, instance.numPoint) {
                     if (instance.drone_cost[x] <= 1e-9) continue;
-                    int keep = rnd.next(100000000) % 100;
-                    
-                    if (keep <= percent_drone_keeping) drone_keeping.push_back( make_pair(phe[x], x) );
+                    if (keep.next()) drone_keeping.push_back( make_pair(phe[x], x) );
                 }
 
                 /// get points which always assigned for drone tour 
@@ -92,19 +270,24 @@ namespace ACO_solution {
                 	cerr<<"("<<drone_keeping[i].second<<", "<<drone_keeping[i].first<<") ";
                 cerr<<"\n";*/
 
-                /// build tsp tour with remain vertice
-                tigersugar::Tour vehicle = NNTourBuilder::ACO_Build_Sub_Tour2(instance, drone_keeping, 0, tsp_phe);
+                /// build tsp tour with remain vertice, or take the one of an earlier ant with the same set
+                uint64_t key = memo ? Memo_Cache::vehicle_set_key(all_customers, drone_keeping) : 0;
+                int vehicle_size = instance.numPoint - (int) drone_keeping.size() + 2;
+                if (!memo || !memo->find(key, vehicle_size, vehicle)) {
+                    NNTourBuilder::ACO_Build_Sub_Tour2(instance, drone_keeping, 0, tsp_phe, vehicle);
 
-                //tigersugar::Tour vehicle = NNTourBuilder::Build_Sub_Tour(instance, drone_keeping, 0);
-                tigersugar::Drone_Tour drone;
-                tsp_optimizer::optimizeTour(instance, vehicle);
+                    //tigersugar::Tour vehicle = NNTourBuilder::Build_Sub_Tour(instance, drone_keeping, 0);
+                    tsp_optimizer::optimizeTour(instance, vehicle);
+                    if (memo) memo->insert(key, vehicle, vehicle.distance(instance));
+                }
+                drone.resize_drones(0); /// the lists are kept for the split to reuse
 
                 /// dynamic programming
                 double cost;
                 if (loop == 1 && ant == 1) cost = vehicle.distance(instance);
                 else cost = max(best_drone_cost, best_vehicle_cost);
 
-                dynamic_programming_split_tour::split(instance, vehicle, drone, drone_keeping, cost);
+                dynamic_programming_split_tour::split(instance, vehicle, drone, drone_keeping, cost, param.pms_improve);
 
                 //cerr << "DP " <<vehicle.distance(instance)<<"(" <<vehicle.size() <<") - "
                 //						<<drone.distance(instance)<<"(" <<drone.size() <<")"<<'\n';
@@ -112,12 +295,9 @@ namespace ACO_solution {
                 tsp_optimizer::optimizeTour(instance, vehicle);
                 /// local search
 
-                while (true) {
-                    bool ok = false;
-                    while ( local_search::optimize_drone(instance, drone) ) { ok = true; }
-                    while ( local_search::optimize(instance, vehicle, drone) ) { ok = true; }
-                    if (!ok) break;
-                }
+                local_search::descend(instance, vehicle, drone, granular);
+
+                diversity += incumbent_edges.distance(vehicle) / nAnts;
 
                 /// update inLoop tour
                 double vehicle_cost = vehicle.distance(instance);
@@ -126,8 +306,8 @@ namespace ACO_solution {
                     best_inLoop_vehicle_cost = vehicle_cost;
                     best_inLoop_drone_cost = drone_cost;
 
-                    best_inLoop_vehicle = vehicle;
-                    best_inLoop_drone = drone;
+                    swap(best_inLoop_vehicle, vehicle); /// the ant's tours are rebuilt by the next ant
+                    swap(best_inLoop_drone, drone);
                 } 
 
             }
@@ -142,24 +322,36 @@ namespace ACO_solution {
 
                 best_vehicle = best_inLoop_vehicle;
                 best_drone = best_inLoop_drone;
-                cerr<<"--- NEW BEST --- at  " << (double)(clock() - startTime) / CLOCKS_PER_SEC << "\n";
-                cout<<"--- NEW BEST --- at  " << (double)(clock() - startTime) / CLOCKS_PER_SEC << "\n";
-                best_time = (double)(clock() - startTime) / CLOCKS_PER_SEC;
+                best_time = cpu_time() - startTime;
                 best_loop = loop;
+                if (context.verbose) {
+                    LOG_DEBUG("--- NEW BEST --- at  " << best_time);
+                    cout<<"--- NEW BEST --- at  " << best_time << "\n";
+                }
             }
 
-            cerr << "#" << loop << ": " <<best_inLoop_vehicle_cost<<"(" <<best_inLoop_vehicle.size() <<") - "
-                						<<best_inLoop_drone_cost<<"(" <<best_inLoop_drone.size() <<") - best "
-                						<<max(best_vehicle_cost, best_drone_cost)<<'\n';
-            cout << "#" << loop << ": " <<best_inLoop_vehicle_cost<<"(" <<best_inLoop_vehicle.size() <<") - "
-                						<<best_inLoop_drone_cost<<"(" <<best_inLoop_drone.size() <<") - best "
-                						<<max(best_vehicle_cost, best_drone_cost)<<'\n';
+            int idle = loop - max(best_loop, last_restart);
+            double branching = Stagnation::branching_factor(tsp_phe);
+            if (context.trace != NULL) {
+                context.trace->record(cpu_time() - startTime, loop,
+                                      best_vehicle_cost, best_drone_cost,
+                                      best_inLoop_vehicle_cost, best_inLoop_drone_cost,
+                                      idle, branching, diversity);
+            }
+            if (context.verbose) {
+                LOG_DEBUG("#" << loop << ": " <<best_inLoop_vehicle_cost<<"(" <<best_inLoop_vehicle.size() <<") - "
+                                              <<best_inLoop_drone_cost<<"(" <<best_inLoop_drone.size() <<") - best "
+                                              <<max(best_vehicle_cost, best_drone_cost));
+                cout << "#" << loop << ": " <<best_inLoop_vehicle_cost<<"(" <<best_inLoop_vehicle.size() <<") - "
+                                            <<best_inLoop_drone_cost<<"(" <<best_inLoop_drone.size() <<") - best "
+                                            <<max(best_vehicle_cost, best_drone_cost)<<'\n';
+            }
 
             /// update phe[]
             for (int x : best_inLoop_vehicle.points) {
                 phe[x] = phe[x] * rho + minPhe * (1-rho); /// x is in vehicle tour
             }
-            for (vector<int> vec : best_inLoop_drone.node) 
+            for (const vector<int> &vec : best_inLoop_drone.node)
                 for (int x : vec) {
                 	phe[x] = phe[x] * rho + maxPhe * (1-rho); /// x is in drone tour
                 	 //cerr<<"("<<x<<","<<phe[x]<<") ";
@@ -185,6 +377,62 @@ namespace ACO_solution {
                     }
                 }
 
+            if (param.adaptive) {
+                controller.update(loop - best_loop, max(best_inLoop_vehicle_cost, best_inLoop_drone_cost),
+                                  previous_best < ORE_INFINITY ? previous_best : 0,
+                                  (cpu_time() - loopStart) / nAnts, param.tLimit - (cpu_time() - startTime),
+                                  nAnts, rho, tsp_rho, percent_drone_keeping);
+                LOG_TRACE("adaptive: nAnts " << nAnts << " rho " << rho << " tsp_rho " << tsp_rho
+                          << " drone keeping " << percent_drone_keeping << "%");
+            }
+
+            /// granular local search: the filter widens while the colony is idle
+            if (param.granular > 0) {
+                if (idle == 0) granular = min(param.granular, tigersugar::NUM_NEIGHBOURS);
+                else if (idle % GRANULAR_WINDOW == 0) granular = min(2 * granular, tigersugar::NUM_NEIGHBOURS);
+            }
+
+            /// stagnation: stop, or forget the pheromone and explore again around the incumbent
+            if (param.stagnation_stop > 0 && loop - best_loop >= param.stagnation_stop) {
+                LOG_INFO("Stagnation at loop " << loop << ", no improvement since loop " << best_loop);
+                stop = "stagnation";
+                break;
+            }
+            if (param.restart > 0 && idle >= param.restart && branching <= param.restart_branching) {
+                FOR(i, 1, instance.numPoint) phe[i] = (instance.drone_cost[i] <= 1e-9) ? 0 : maxPhe;
+                FOR(u, 0, instance.numPoint) fill(tsp_phe[u].begin(), tsp_phe[u].end(), maxPhe);
+                last_restart = loop;
+                ++restarts;
+                LOG_DEBUG("Pheromone reset at loop " << loop << " (branching factor " << branching << ")");
+            }
+
+            /// save the colony
+            if (context.checkpoint && Checkpoint::enabled() && cpu_time() - lastCheckpoint >= Checkpoint::interval) {
+                Checkpoint::Colony &colony = Checkpoint::colony;
+                colony.loop = loop;
+                colony.elapsed = cpu_time() - startTime;
+                colony.best_time = best_time;
+                colony.best_loop = best_loop;
+                colony.best_vehicle_cost = best_vehicle_cost;
+                colony.best_drone_cost = best_drone_cost;
+                colony.restarts = restarts;
+                colony.last_restart = last_restart;
+                colony.nAnts = nAnts;
+                colony.percent_drone_keeping = percent_drone_keeping;
+                colony.rho = rho;
+                colony.tsp_rho = tsp_rho;
+                colony.controller = controller;
+                colony.granular = granular;
+                colony.phe = phe;
+                colony.tsp_phe = tsp_phe;
+                colony.best_vehicle = best_vehicle;
+                colony.best_drone = best_drone;
+                memcpy(colony.rng, Rng::solver.s, sizeof(colony.rng));
+                if (context.trace != NULL) context.trace->flush();
+                Checkpoint::save_colony();
+                lastCheckpoint = cpu_time();
+            }
+
             /*
             double p = 0;
             for (int step=0; step<100; step++) {
@@ -203,13 +451,67 @@ namespace ACO_solution {
 
         } 
 
+        Result result;
+        result.cost = max( best_vehicle.distance(instance), best_drone.distance(instance) );
+        result.vehicle = best_vehicle;
+        result.drone = best_drone;
+        result.best_time = best_time;
+        result.best_loop = best_loop;
+        result.num_loop = numOutLoop;
+        result.elapsed = cpu_time() - startTime;
+        result.lower_bound = lower_bound;
+        result.optimal = result.cost <= lower_bound * (1 + 1e-9) + 1e-6;
+        result.restarts = restarts;
+        result.stop = stop;
+        if (memo) {
+            result.memo = memo->stats();
+            LOG_INFO("memo cache: " << result.memo.hits << " hits, " << result.memo.misses << " misses, "
+                     << result.memo.entries << " entries, " << result.memo.evictions << " evictions, "
+                     << result.memo.bytes / 1024 << " KB");
+        }
+        return result;
+    }
+
+    void process(tigersugar::Instance &instance) {
+        Context context;
+        context.param = default_parameters(instance);
+        context.initial = &initial;
+        context.trace = Convergence_Trace::trace.enabled() ? &Convergence_Trace::trace : NULL;
+        context.checkpoint = true;
+        context.verbose = context.trace == NULL;
+
+        const Parameters &param = context.param;
+        LOG_INFO("rho                  "<<param.rho);
+        LOG_INFO("tsp_rho              "<<param.tsp_rho);
+        LOG_INFO("nAnts                "<<param.nAnts);
+        LOG_INFO("iLimit               "<<param.iLimit);
+        LOG_INFO("tLimit               "<<param.tLimit);
+
+        cout<<"rho                  "<<param.rho<<"\n";
+        cout<<"tsp_rho              "<<param.tsp_rho<<"\n";
+        cout<<"nAnts                "<<param.nAnts<<"\n";
+        cout<<"iLimit               "<<param.iLimit<<"\n";
+        cout<<"tLimit               "<<param.tLimit<<"\n";
+
+        Result result = solve(instance, context);
+
         /// Output
-        Problem::result = max( best_vehicle.distance(instance), best_drone.distance(instance) );
-        Problem::vTour = best_vehicle.points;
-        Problem::dTour = best_drone.node;
-        Problem::numOutLoop = best_loop;
-        Problem::excutionTime = best_time;
-        cerr << "\n\nbest loop: " << best_loop<<" best time: "<<best_time<<" Excution time: " << (double)(clock() - startTime) / CLOCKS_PER_SEC << "\n\n";
-        cout << "\n\nbest loop: " << best_loop<<" best time: "<<best_time<<" Excution time: " << (double)(clock() - startTime) / CLOCKS_PER_SEC << "\n\n";
+        Problem::result = result.cost;
+        Problem::vTour = result.vehicle.points;
+        Problem::dTour = result.drone.node;
+        Problem::numOutLoop = result.best_loop;
+        Problem::excutionTime = result.best_time;
+        cout << "LOWER BOUND: " << result.lower_bound << "\n";
+        if (result.optimal) cout << "OPTIMAL\n";
+        if (context.param.memo_cache > 0) {
+            long long lookups = result.memo.hits + result.memo.misses;
+            cout << "MEMO CACHE: " << result.memo.hits << "/" << lookups << " hits ("
+                 << (lookups ? 100.0 * result.memo.hits / lookups : 0) << "%), " << result.memo.bytes / 1024 << " KB\n";
+        }
+        LOG_INFO("stop: " << result.stop << " restarts: " << result.restarts);
+        LOG_INFO("best loop: " << result.best_loop<<" best time: "<<result.best_time<<" Excution time: " << result.elapsed);
+        cout << "\n\nbest loop: " << result.best_loop<<" best time: "<<result.best_time<<" Excution time: " << result.elapsed << "\n\n";
     }
-}
\ No newline at end of file
+}
+
+#endif
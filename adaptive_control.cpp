@@ -0,0 +1,78 @@
+#ifndef PDSTSP_ADAPTIVE_CONTROL
+#define PDSTSP_ADAPTIVE_CONTROL
+
+#include "template.cpp"
+#include "rng.cpp"
+
+/*
+ * Online control of the colony parameters (--adaptive), updated after every loop.
+ *  - nAnts: sized so that the remaining time budget still holds TARGET_LOOPS loops at the
+ *    measured cost of one ant (construction + 3-opt + split + local search).
+ *  - percent_drone_keeping: epsilon-greedy choice among ARMS, rewarded by the quality of the
+ *    loop's best ant relative to the incumbent.
+ *  - rho, tsp_rho: back to the base rate after an improvement, raised toward MAX_RHO while the
+ *    colony is idle so the pheromone moves slower and the ants spread more.
+ */
+namespace Adaptive_Control
+{
+    const int TARGET_LOOPS = 50;
+    const int WINDOW = 5;
+    const double EPSILON = 0.2;
+    const double MAX_RHO = 0.98;
+    const int NUM_ARMS = 3;
+    const int ARMS[NUM_ARMS] = { 25, 50, 75 };
+
+    struct Controller {
+        int min_ants, max_ants;
+        double base_rho, base_tsp_rho;
+        double reward[NUM_ARMS];
+        int pulls[NUM_ARMS];
+        int arm;
+
+        Controller() {}
+
+        Controller(int nAnts, double rho, double tsp_rho) {
+            max_ants = max(1, nAnts);
+            min_ants = max(1, min(max_ants, max(4, nAnts / 8)));
+            base_rho = rho;
+            base_tsp_rho = tsp_rho;
+            REP(i, NUM_ARMS) { reward[i] = 0; pulls[i] = 0; }
+            arm = 1;
+        }
+
+        /// loop_best / incumbent: costs of the last loop, ant_time: CPU seconds per ant, remaining: seconds left
+        void update(int idle, double loop_best, double incumbent, double ant_time, double remaining,
+                    int &nAnts, double &rho, double &tsp_rho, int &percent_drone_keeping) {
+            /// colony size
+            if (ant_time > 0 && remaining > 0) {
+                double fit = remaining / (TARGET_LOOPS * ant_time);
+                nAnts = (int) max((double) min_ants, min((double) max_ants, fit));
+            }
+
+            /// drone keeping: reward of the arm used in the last loop
+            if (loop_best > 0 && incumbent > 0) {
+                reward[arm] += min(1.0, incumbent / loop_best);
+                ++pulls[arm];
+            }
+            int best_arm = 0;
+            REP(i, NUM_ARMS) {
+                if (pulls[i] == 0) { best_arm = i; break; }
+                if (reward[i] / pulls[i] > reward[best_arm] / pulls[best_arm]) best_arm = i;
+            }
+            arm = (Rng::solver.next_double() < EPSILON) ? Rng::solver.next_int(NUM_ARMS) : best_arm;
+            percent_drone_keeping = ARMS[arm];
+
+            /// evaporation
+            if (idle == 0) {
+                rho = base_rho;
+                tsp_rho = base_tsp_rho;
+            }
+            else if (idle % WINDOW == 0) {
+                rho = min(MAX_RHO, rho + (MAX_RHO - rho) / 2);
+                tsp_rho = min(MAX_RHO, tsp_rho + (MAX_RHO - tsp_rho) / 2);
+            }
+        }
+    };
+}
+
+#endif
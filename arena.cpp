@@ -0,0 +1,115 @@
+#ifndef PDSTSP_ARENA
+#define PDSTSP_ARENA
+
+#include "template.cpp"
+
+/*
+ * Per-thread monotonic arena for the short-lived containers of the ant kernels (tour
+ * construction, 2-opt / 3-opt, split). Allocation is a pointer bump in blocks that are
+ * kept for the life of the thread, deallocation does nothing. A kernel opens an
+ * Arena::Scope on entry, which rewinds the arena on exit, so every ant reuses the same
+ * memory and malloc is only called while the arena grows to the largest ant.
+ *
+ * Containers: Arena::Vector<T>, or any std container with Arena::Allocator<T>. They
+ * must not outlive the innermost Scope open when they allocated.
+ */
+namespace Arena
+{
+    const size_t BLOCK_SIZE = 1 << 20;
+
+    class Monotonic {
+    public:
+        struct Mark {
+            size_t block, used;
+        };
+
+        Monotonic() : block(0), used(0) {}
+
+        ~Monotonic() {
+            for (Block &b : blocks) free(b.data);
+        }
+
+        void *allocate(size_t bytes, size_t align) {
+            while (true) {
+                if (block < blocks.size()) {
+                    size_t start = (used + align - 1) & ~(align - 1);
+                    if (start + bytes <= blocks[block].size) {
+                        used = start + bytes;
+                        return blocks[block].data + start;
+                    }
+                    ++block;
+                    used = 0;
+                    continue;
+                }
+                Block b;
+                b.size = max(BLOCK_SIZE, bytes + align);
+                b.data = (char *) malloc(b.size);
+                if (b.data == NULL) throw bad_alloc();
+                blocks.push_back(b);
+            }
+        }
+
+        Mark mark() const {
+            Mark m;
+            m.block = block;
+            m.used = used;
+            return m;
+        }
+
+        void release(const Mark &m) {
+            block = m.block;
+            used = m.used;
+        }
+
+        /// bytes held by the arena
+        size_t capacity() const {
+            size_t res = 0;
+            for (const Block &b : blocks) res += b.size;
+            return res;
+        }
+
+    private:
+        struct Block {
+            char *data;
+            size_t size;
+        };
+
+        vector<Block> blocks;
+        size_t block, used;
+    };
+
+    thread_local Monotonic arena;
+
+    /// rewinds the thread's arena to where it was on construction
+    struct Scope {
+        Monotonic::Mark mark;
+
+        Scope() : mark(arena.mark()) {}
+        ~Scope() { arena.release(mark); }
+
+        Scope(const Scope &) = delete;
+        Scope &operator = (const Scope &) = delete;
+    };
+
+    template<class T>
+    struct Allocator {
+        typedef T value_type;
+
+        Allocator() {}
+        template<class U> Allocator(const Allocator<U> &) {}
+
+        T *allocate(size_t n) {
+            return (T *) arena.allocate(n * sizeof(T), alignof(T));
+        }
+
+        void deallocate(T *, size_t) {}
+
+        template<class U> bool operator == (const Allocator<U> &) const { return true; }
+        template<class U> bool operator != (const Allocator<U> &) const { return false; }
+    };
+
+    template<class T>
+    using Vector = vector<T, Allocator<T> >;
+}
+
+#endif
@@ -0,0 +1,71 @@
+#!/bin/bash
+# Smoke test of the daemon: sends a fixed set of requests to PDSTSP --daemon and checks every
+# response. A plan must visit each customer exactly once, the vehicle tour must start and end at
+# the depot and a plan has one list per drone. Without drones (0-drone solves and the deltas on
+# them) the vehicle must serve every customer.
+#
+# usage: benchmark/daemon_test.sh [-b binary]
+
+BIN=./PDSTSP
+
+while getopts "b:" opt; do
+    case $opt in
+        b) BIN=$OPTARG ;;
+        *) exit 2 ;;
+    esac
+done
+
+# request id, expected number of drones and of customers, one line per request
+EXPECTED="1 0 48
+2 0 4
+3 0 4
+4 2 48
+5 1 3
+6 1 3"
+
+# one worker answers the requests in order, so a delta sees the plan of the solve before it
+responses=$("$BIN" --daemon --workers 1 --log-level error <<'REQUESTS'
+{"id": 1, "instance": "att48_0_80.csv", "drones": 0, "vehicle_speed": 1, "drone_speed": 2, "time_limit": 0.3}
+{"id": 2, "key": "none", "points": [[0, 0, 0], [10, 0, 1], [0, 10, 1], [5, 5, 1], [40, 40, 1]], "drones": 0, "time_limit": 0.2}
+{"id": 3, "op": "delta", "key": "none", "add": [[20, 20, 1]], "remove": [2], "time_limit": 0.1}
+{"id": 4, "instance": "att48_0_80.csv", "drones": 2, "vehicle_speed": 1, "drone_speed": 2, "time_limit": 0.3}
+{"id": 5, "key": "one", "points": [[0, 0, 0], [10, 0, 1], [0, 10, 0], [5, 5, 1]], "drones": 1, "time_limit": 0.2}
+{"id": 6, "op": "delta", "key": "one", "add": [[30, 0, 1]], "remove": [1], "time_limit": 0.1}
+REQUESTS
+)
+
+failed=0
+while read -r id drones customers; do
+    response=$(grep -m1 "^{\"id\":$id," <<< "$responses")
+    if [ -z "$response" ]; then
+        echo "request $id: no response"; failed=1; continue
+    fi
+    if grep -q '"error"' <<< "$response"; then
+        echo "request $id: $response"; failed=1; continue
+    fi
+    problem=$(awk -v drones="$drones" -v customers="$customers" -v line="$response" 'BEGIN {
+        match(line, /"vehicle":\[[^]]*\]/); vehicle = substr(line, RSTART + 11, RLENGTH - 12)
+        match(line, /"drones":\[(\[[^]]*\],?)*\]/); fleet = substr(line, RSTART + 10, RLENGTH - 11)
+        nv = split(vehicle, v, ",")
+        if (v[1] != 0 || v[nv] != 0) { print "the vehicle tour does not start and end at the depot"; exit }
+        for (i = 2; i < nv; ++i) seen[v[i]]++
+        lists = 0; on_drone = 0
+        while (match(fleet, /\[[^]]*\]/)) {
+            ++lists
+            nd = split(substr(fleet, RSTART + 1, RLENGTH - 2), d, ",")
+            for (i = 1; i <= nd; ++i) { seen[d[i]]++; ++on_drone }
+            fleet = substr(fleet, RSTART + RLENGTH)
+        }
+        if (lists != drones) { print lists " drone lists for " drones " drones"; exit }
+        if (drones == 0 && on_drone > 0) { print on_drone " customers on a drone without drones"; exit }
+        for (i = 1; i <= customers; ++i) if (seen[i] != 1) { print "customer " i " is served " seen[i] + 0 " times"; exit }
+        for (x in seen) if (x + 0 < 1 || x + 0 > customers) { print "unknown customer " x; exit }
+    }')
+    if [ -n "$problem" ]; then
+        echo "request $id: $problem"; echo "    $response"; failed=1
+    else
+        echo "request $id: ok"
+    fi
+done <<< "$EXPECTED"
+
+exit $failed
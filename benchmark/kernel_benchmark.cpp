@@ -0,0 +1,257 @@
+/*
+ * Micro benchmark of the solver kernels.
+ * Each kernel is timed in isolation on fixed-seed inputs built from the data/ instances,
+ * and reported as ns/op and heap allocations/op.
+ *
+ * g++ benchmark/kernel_benchmark.cpp --std=c++11 -O2 -pthread -o kernel_benchmark
+ * ./kernel_benchmark [--input att48_0_80.csv ...] [--drone 2] [--min-time 0.5] [--seed 1] [--renumber hilbert]
+ */
+#include "../template.cpp"
+#include "../problem.cpp"
+#include "../paper_Input_adaptation.cpp"
+#include "../ACO_solution.cpp"
+#include "../renumber.cpp"
+
+namespace Allocation_Counter {
+    atomic<long long> count(0);
+
+    void* allocate(size_t size) {
+        count.fetch_add(1, memory_order_relaxed);
+        void *p = malloc(size == 0 ? 1 : size);
+        if (p == NULL) throw bad_alloc();
+        return p;
+    }
+}
+
+/// every replaceable form, so that all allocations are counted and each delete matches its new
+void* operator new(size_t size) { return Allocation_Counter::allocate(size); }
+void* operator new[](size_t size) { return Allocation_Counter::allocate(size); }
+void operator delete(void *p) noexcept { free(p); }
+void operator delete[](void *p) noexcept { free(p); }
+void operator delete(void *p, size_t) noexcept { free(p); }
+void operator delete[](void *p, size_t) noexcept { free(p); }
+
+namespace Kernel_Benchmark {
+    const int BATCH = 64;
+
+    double min_time = 0.5;
+    bool failed = false; /// a warm ant allocated
+    long long seed = 1;
+    string renumber = "none";
+
+    /// setup(k) prepares the inputs of k operations outside the timed region, body(j) runs operation j
+    template<class Setup, class Body>
+    void measure(const string &instance_name, const string &kernel, Setup setup, Body body) {
+        long long ops = 0, allocations = 0;
+        double elapsed = 0;
+
+        while (elapsed < min_time) {
+            setup(BATCH);
+
+            long long alloc_before = Allocation_Counter::count.load();
+            chrono::steady_clock::time_point start = chrono::steady_clock::now();
+            REP(j, BATCH) body(j);
+            chrono::steady_clock::time_point finish = chrono::steady_clock::now();
+            allocations += Allocation_Counter::count.load() - alloc_before;
+
+            elapsed += chrono::duration<double>(finish - start).count();
+            ops += BATCH;
+        }
+
+        printf("%-16s %-28s %14.1f %12.2f %10lld\n", instance_name.c_str(), kernel.c_str(),
+               elapsed * 1e9 / ops, (double) allocations / ops, ops);
+        fflush(stdout);
+    }
+
+    int customers_of(const string &input) {
+        int customer = 0;
+        for (int i = 0; i < (int) input.size(); ++i)
+            if ( isdigit(input[i]) ) {
+                while ( isdigit(input[i]) ) customer = customer * 10 + input[i] - '0', ++i;
+                break;
+            }
+        return customer;
+    }
+
+    /// same sampling as one ant of ACO_solution::process with a uniform pheromone
+    vector<pair<double, int> > sample_drone_keeping(tigersugar::Instance &instance) {
+        vector<pair<double, int> > drone_keeping;
+        FOR(x, 1, instance.numPoint) {
+            if (instance.drone_cost[x] <= 1e-9) continue;
+            if (Rng::solver.next_int(100) <= 50) drone_keeping.push_back( make_pair(1.0, x) );
+        }
+        while ((int) drone_keeping.size() > instance.numPoint / 4) drone_keeping.pop_back();
+        return drone_keeping;
+    }
+
+    void run_instance(const string &input, int numDrone) {
+        Problem::import_data_from_tsplib_instance(input, customers_of(input), numDrone, 1, 2, 1, 1, "");
+        tigersugar::Instance instance = Renumber::build(renumber, Problem::points).apply(Input_Adaptation::Process());
+        Rng::seed_stream(seed, 0);
+
+        vector<vector<double> > tsp_phe(instance.numPoint+1, vector<double>(instance.numPoint+1, 1.0));
+        vector<pair<double, int> > drone_keeping = sample_drone_keeping(instance);
+
+        /// reference state: constructed tour, split and local search as in one ant
+        tigersugar::Tour built;
+        NNTourBuilder::ACO_Build_Sub_Tour2(instance, drone_keeping, 0, tsp_phe, built);
+        tigersugar::Tour optimized = built;
+        tsp_optimizer::optimizeTour(instance, optimized);
+
+        tigersugar::Tour vehicle = optimized;
+        tigersugar::Drone_Tour drone;
+        dynamic_programming_split_tour::split(instance, vehicle, drone, drone_keeping, vehicle.distance(instance));
+        double best_cost = max(vehicle.distance(instance), drone.distance(instance));
+
+        tsp_optimizer::Tour mapped;
+        for (int x : built.points) if (x != 0) mapped.nodes.push_back(x);
+        mapped = tsp_optimizer::Tour(mapped.nodes);
+        tsp_optimizer::TspProblem<> problem(instance, mapped);
+        vector<int> identity;
+        REP(i, mapped.length() - 1) identity.push_back(i);
+        identity.push_back(0);
+
+        vector<vector<int> > tours(BATCH);
+        vector<tigersugar::Tour> vehicles(BATCH);
+        vector<tigersugar::Drone_Tour> drones(BATCH);
+
+        measure(input, "two_opt_first",
+                [&](int k) { REP(j, k) tours[j] = identity; },
+                [&](int j) { tsp_optimizer::two_opt_first(tours[j], problem); });
+
+        measure(input, "three_opt_first",
+                [&](int k) { REP(j, k) tours[j] = identity; },
+                [&](int j) { tsp_optimizer::three_opt_first(tours[j], problem); });
+
+        measure(input, "TspProblem",
+                [&](int) {},
+                [&](int) { Arena::Scope scope; tsp_optimizer::TspProblem<> foo(instance, mapped); });
+
+        /// the same searches on the integer matrices, when the distances allow them
+        if (instance.cost_type != tigersugar::REAL_COST) {
+            tsp_optimizer::TspProblem<int> int_problem(instance, mapped);
+            measure(input, "three_opt_first int32",
+                    [&](int k) { REP(j, k) tours[j] = identity; },
+                    [&](int j) { tsp_optimizer::three_opt_first(tours[j], int_problem); });
+        }
+        if (instance.cost_type == tigersugar::SHORT_COST) {
+            tsp_optimizer::TspProblem<uint16_t> short_problem(instance, mapped);
+            measure(input, "three_opt_first uint16",
+                    [&](int k) { REP(j, k) tours[j] = identity; },
+                    [&](int j) { tsp_optimizer::three_opt_first(tours[j], short_problem); });
+        }
+
+        measure(input, "ACO_Build_Sub_Tour2",
+                [&](int) {},
+                [&](int j) { NNTourBuilder::ACO_Build_Sub_Tour2(instance, drone_keeping, 0, tsp_phe, vehicles[j]); });
+
+        measure(input, "split",
+                [&](int k) { REP(j, k) { vehicles[j] = optimized; drones[j].resize_drones(0); } },
+                [&](int j) { dynamic_programming_split_tour::split(instance, vehicles[j], drones[j], drone_keeping, best_cost); });
+
+        measure(input, "pms_optimizer::optimizeTour",
+                [&](int k) {
+                    REP(j, k) {
+                        drones[j].resize_drones(1);
+                        drones[j].node[0].clear();
+                        for (const vector<int> &vec : drone.node) for (int x : vec) drones[j].node[0].push_back(x);
+                    }
+                },
+                [&](int j) { pms_optimizer::optimizeTour(instance, drones[j]); });
+
+        measure(input, "pms_optimizer::optimizeTour improve",
+                [&](int k) {
+                    REP(j, k) {
+                        drones[j].resize_drones(1);
+                        drones[j].node[0].clear();
+                        for (const vector<int> &vec : drone.node) for (int x : vec) drones[j].node[0].push_back(x);
+                    }
+                },
+                [&](int j) { pms_optimizer::optimizeTour(instance, drones[j], true); });
+
+        measure(input, "local_search::optimize",
+                [&](int k) { REP(j, k) { vehicles[j] = vehicle; drones[j] = drone; } },
+                [&](int j) { local_search::optimize(instance, vehicles[j], drones[j]); });
+
+        measure(input, "local_search::optimize_drone",
+                [&](int k) { REP(j, k) drones[j] = drone; },
+                [&](int j) { local_search::optimize_drone(instance, drones[j]); });
+
+        measure(input, "local_search::relocate",
+                [&](int k) { REP(j, k) { vehicles[j] = vehicle; drones[j] = drone; } },
+                [&](int j) { local_search::relocate(instance, vehicles[j], drones[j]); });
+
+        measure(input, "local_search::full_pass loop",
+                [&](int k) { REP(j, k) { vehicles[j] = vehicle; drones[j] = drone; } },
+                [&](int j) { while ( local_search::full_pass(instance, vehicles[j], drones[j]) ); });
+
+        measure(input, "local_search::descend",
+                [&](int k) { REP(j, k) { vehicles[j] = vehicle; drones[j] = drone; } },
+                [&](int j) { local_search::descend(instance, vehicles[j], drones[j]); });
+
+        measure(input, "local_search::descend granular 8",
+                [&](int k) { REP(j, k) { vehicles[j] = vehicle; drones[j] = drone; } },
+                [&](int j) { local_search::descend(instance, vehicles[j], drones[j], 8); });
+
+        /// one whole ant as in ACO_solution::solve, its tours kept across ants like the colony does
+        tigersugar::Tour ant_vehicle, ant_best_vehicle;
+        tigersugar::Drone_Tour ant_drone, ant_best_drone;
+        auto ant = [&]() {
+            NNTourBuilder::ACO_Build_Sub_Tour2(instance, drone_keeping, 0, tsp_phe, ant_vehicle);
+            tsp_optimizer::optimizeTour(instance, ant_vehicle);
+            ant_drone.resize_drones(0);
+            dynamic_programming_split_tour::split(instance, ant_vehicle, ant_drone, drone_keeping, best_cost);
+            tsp_optimizer::optimizeTour(instance, ant_vehicle);
+            local_search::descend(instance, ant_vehicle, ant_drone);
+            swap(ant_best_vehicle, ant_vehicle);
+            swap(ant_best_drone, ant_drone);
+        };
+        measure(input, "ant", [&](int) {}, [&](int) { ant(); });
+
+        /// the ants above warmed the tours, the scratch and the arena up: an ant must not allocate any more
+        long long alloc_before = Allocation_Counter::count.load();
+        REP(j, BATCH) ant();
+        long long ant_allocations = Allocation_Counter::count.load() - alloc_before;
+        if (ant_allocations > 0) {
+            printf("%-16s %-28s %lld allocations in %d warm ants, expected none\n", input.c_str(), "ant check",
+                   ant_allocations, BATCH);
+            failed = true;
+        }
+
+        double sink = 0;
+        measure(input, "Drone_Tour::distance",
+                [&](int) {},
+                [&](int) { sink += drone.distance(instance); });
+        if (sink < 0) printf("%f\n", sink);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    vector<string> inputs;
+    int drone = 2;
+
+    for (int i = 1; i < argc; ++i) {
+        string key = argv[i];
+        if (key == "--input") inputs.push_back(argv[++i]);
+        else if (key == "--drone") drone = stoi(argv[++i]);
+        else if (key == "--min-time") Kernel_Benchmark::min_time = stof(argv[++i]);
+        else if (key == "--seed") Kernel_Benchmark::seed = stoll(argv[++i]);
+        else if (key == "--renumber") Kernel_Benchmark::renumber = argv[++i];
+        else {
+            cerr << "Unknow argument " << argv[i] << "!\n";
+            return 0;
+        }
+    }
+
+    if (inputs.empty()) {
+        string defaults[] = { "att48_0_80.csv", "berlin52_0_80.csv", "eil101_0_80.csv",
+                              "gr120_0_80.csv", "pr152_0_80.csv", "gr229_0_80.csv" };
+        for (const string &input : defaults) inputs.push_back(input);
+    }
+
+    Logger::max_level = Logger::LEVEL_ERROR;
+    printf("%-16s %-28s %14s %12s %10s\n", "instance", "kernel", "ns/op", "allocs/op", "ops");
+    for (const string &input : inputs) Kernel_Benchmark::run_instance(input, drone);
+    return Kernel_Benchmark::failed ? 1 : 0;
+}
@@ -0,0 +1,111 @@
+#!/bin/bash
+# End-to-end quality-vs-time benchmark against data/reference_results.txt.
+# Runs every configuration of the run* scripts with a fixed budget, then reports for each one
+# the gap to the reference value, the time to reach the target gap and the primal integral.
+#
+# usage: benchmark/quality_benchmark.sh [-b binary] [-t budget] [-r runs] [-g target gap]
+#                                       [-x tolerance] [-c baseline summary] [-o output folder] [-f filter]
+#                                       [-s seed]
+#
+#   -t  time limit of one run in seconds (default 10)
+#   -r  number of runs per configuration (default 3)
+#   -g  relative gap counted as "target reached" for the time-to-target (default 0.01)
+#   -x  a configuration is a regression when its average gap exceeds the reference by more than this,
+#       or exceeds the baseline average gap by more than this when -c is given (default 0.02)
+#   -c  summary.txt of an earlier benchmark to compare against
+#   -f  only run configurations whose input matches this pattern
+#   -s  seed of the solver, run k of a configuration uses stream k of this seed (default 1)
+
+BIN=./PDSTSP
+BUDGET=10
+RUNS=3
+TARGET=0.01
+TOLERANCE=0.02
+BASELINE=""
+OUT=bench_results
+FILTER=""
+SEED=1
+
+while getopts "b:t:r:g:x:c:o:f:s:" opt; do
+    case $opt in
+        b) BIN=$OPTARG ;;
+        t) BUDGET=$OPTARG ;;
+        r) RUNS=$OPTARG ;;
+        g) TARGET=$OPTARG ;;
+        x) TOLERANCE=$OPTARG ;;
+        c) BASELINE=$OPTARG ;;
+        o) OUT=$OPTARG ;;
+        f) FILTER=$OPTARG ;;
+        s) SEED=$OPTARG ;;
+        *) exit 2 ;;
+    esac
+done
+
+REFERENCE=data/reference_results.txt
+mkdir -p output "$OUT/traces"
+SUMMARY=$OUT/summary.txt
+
+printf "%-18s %6s %6s %10s %10s %10s %8s %8s %9s %9s  %s\n" \
+    instance drones speed reference best average gap% avg-gap% ttt pi status > "$SUMMARY"
+
+regressions=0
+
+while read -r _ input _ drones _ vehicle_speed _ drone_speed; do
+    [[ -n "$FILTER" && "$input" != *$FILTER* ]] && continue
+
+    reference=$(awk -v i="$input" -v d="$drones" -v s="$drone_speed" \
+        '$1 == i && $2 == d && $3 == s { print $6 }' "$REFERENCE")
+    if [[ -z "$reference" ]]; then
+        echo "no reference for $input drone $drones drone-speed $drone_speed, skipped" >&2
+        continue
+    fi
+
+    name="${input%.csv}_d${drones}_s${drone_speed}"
+    trace="$OUT/traces/$name.csv"
+    "$BIN" --input "$input" --drone "$drones" --vehicle-speed "$vehicle_speed" --drone-speed "$drone_speed" \
+        --time-limit "$BUDGET" --runs "$RUNS" --seed "$SEED" --trace "$trace" --log-level error > /dev/null
+
+    baseline_gap=""
+    if [[ -n "$BASELINE" ]]; then
+        baseline_gap=$(awk -v i="$input" -v d="$drones" -v s="$drone_speed" \
+            '$1 == i && $2 == d && $3 == s { print $8 }' "$BASELINE")
+    fi
+
+    line=$(awk -F, -v ref="$reference" -v budget="$BUDGET" -v target="$TARGET" \
+               -v tolerance="$TOLERANCE" -v baseline="$baseline_gap" '
+        function gap(cost) { g = (cost - ref) / (cost > ref ? cost : ref); return g > 0 ? g : 0 }
+        NR == 1 { next }
+        {
+            t = $1; r = $2; cost = $6
+            if (!(r in last_time)) { runs[++nRuns] = r; integral[r] = t; last_time[r] = t; last_gap[r] = 1 }
+            integral[r] += last_gap[r] * (t - last_time[r])
+            last_time[r] = t; last_gap[r] = gap(cost); final[r] = cost
+            if (!(r in ttt) && cost <= ref * (1 + target)) ttt[r] = t
+        }
+        END {
+            if (nRuns == 0) { printf "%10s %10s %10s %8s %8s %9s %9s  %s", ref, "-", "-", "-", "-", "-", "-", "FAILED"; exit }
+            best = -1; sum = 0; pi = 0; reached = 0; sum_ttt = 0
+            for (k = 1; k <= nRuns; ++k) {
+                r = runs[k]
+                if (last_time[r] < budget) integral[r] += last_gap[r] * (budget - last_time[r])
+                pi += integral[r]; sum += final[r]
+                if (best < 0 || final[r] < best) best = final[r]
+                if (r in ttt) { reached++; sum_ttt += ttt[r] }
+            }
+            average = sum / nRuns
+            avg_gap = 100 * (average - ref) / ref
+            status = "ok"
+            if (avg_gap > 100 * tolerance) status = "REGRESSION"
+            if (baseline != "" && avg_gap > baseline + 100 * tolerance) status = "REGRESSION"
+            printf "%10.2f %10.2f %10.2f %8.3f %8.3f %9s %9.3f  %s", ref, best, average,
+                   100 * (best - ref) / ref, avg_gap,
+                   (reached > 0 ? sprintf("%.3f", sum_ttt / reached) : "-"), pi / nRuns, status
+        }' "$trace")
+
+    printf "%-18s %6s %6s %s\n" "$input" "$drones" "$drone_speed" "$line" | tee -a "$SUMMARY"
+    [[ "$line" != *ok ]] && regressions=$((regressions + 1))
+done < <(grep -ho -- '--input [^ ]* --drone [0-9]* --vehicle-speed [0-9.]* --drone-speed [0-9.]*' run*.bat runALL.sh \
+             | tr -d '\r' | sort -u)
+
+echo "$regressions regression(s), summary written to $SUMMARY"
+[[ $regressions -eq 0 ]]
@@ -0,0 +1,204 @@
+#ifndef PDSTSP_CHECKPOINT
+#define PDSTSP_CHECKPOINT
+
+#include "paper/utilities.cpp"
+#include "point.cpp"
+#include "rng.cpp"
+#include "logger.cpp"
+#include "adaptive_control.cpp"
+
+/*
+ * Binary checkpoint of a winter_main job: the summary of the finished runs and, while a run
+ * is in progress, the colony state of ACO_solution::solve (pheromones, incumbent, loop,
+ * elapsed time, restarts, --adaptive controller, --granular width and RNG state). The header
+ * identifies the job (instance data, fleet, speeds, numbering): a file of another job is rejected. The file is written to <file>.tmp and renamed over <file>.
+ */
+namespace Checkpoint
+{
+    const char MAGIC[8] = { 'P', 'D', 'S', 'T', 'S', 'P', 'C', '5' };
+
+    struct Header {
+        int numPoint = 0, numDrone = 0;
+        double vehicle_speed = 0, drone_speed = 0;
+        int renumber = 0;      // 1 for --renumber hilbert
+        uint64_t instance = 0; // hash of the coordinates and drone eligibility
+    };
+
+    struct Summary {
+        int finished_runs = 0;
+        double sum_result = 0, sum_time = 0, sum_loop = 0;
+        double max_result = -1, min_result = -1;
+    };
+
+    struct Colony {
+        int loop = 0; // last finished loop, 0 if the run has not started
+        double elapsed = 0, best_time = 0, best_loop = 0;
+        double best_vehicle_cost = 0, best_drone_cost = 0;
+        int restarts = 0, last_restart = 0; // pheromone resets so far, loop of the last one
+        int nAnts = 0, percent_drone_keeping = 0; // colony parameters, moved by --adaptive
+        double rho = 0, tsp_rho = 0;
+        Adaptive_Control::Controller controller;
+        int granular = 0; // current width of the granular filter
+        vector<double> phe;
+        vector<vector<double> > tsp_phe;
+        tigersugar::Tour best_vehicle;
+        tigersugar::Drone_Tour best_drone;
+        uint64_t rng[4];
+    };
+
+    string file;
+    Header header; // job being run, set before load and save
+    double interval = 30.0;
+    int run = 0; // run being processed
+
+    Summary summary;
+    Colony colony;
+    bool pending = false; // colony has been loaded and not yet consumed by ACO_solution::solve
+
+    bool enabled() {
+        return !file.empty();
+    }
+
+    template<class T> void write_pod(FILE *f, const T &val) { fwrite(&val, sizeof(T), 1, f); }
+    template<class T> bool read_pod(FILE *f, T &val) { return fread(&val, sizeof(T), 1, f) == 1; }
+
+    template<class T> void write_vector(FILE *f, const vector<T> &vec) {
+        write_pod(f, (int) vec.size());
+        if (!vec.empty()) fwrite(vec.data(), sizeof(T), vec.size(), f);
+    }
+
+    template<class T> bool read_vector(FILE *f, vector<T> &vec) {
+        int size;
+        if (!read_pod(f, size) || size < 0) return false;
+        vec.resize(size);
+        return size == 0 || fread(vec.data(), sizeof(T), size, f) == (size_t) size;
+    }
+
+    /// hash of the instance data, see Header::instance
+    uint64_t instance_hash(const vector<Point::point> &points, const vector<bool> &drone_eligible) {
+        uint64_t h = 0xcbf29ce484222325ULL;
+        auto mix = [&] (uint64_t x) { h = (h ^ x) * 0x100000001b3ULL; h ^= h >> 29; };
+        REP(i, points.size()) {
+            uint64_t x, y;
+            memcpy(&x, &points[i].x, sizeof(x));
+            memcpy(&y, &points[i].y, sizeof(y));
+            mix(x);
+            mix(y);
+            mix(drone_eligible[i]);
+        }
+        return h;
+    }
+
+    void save(bool with_colony) {
+        string tmp_file = file + ".tmp";
+        FILE *f = fopen(tmp_file.c_str(), "wb");
+        if (f == NULL) {
+            LOG_ERROR("Can not write checkpoint " << tmp_file);
+            return;
+        }
+
+        fwrite(MAGIC, 1, sizeof(MAGIC), f);
+        write_pod(f, header);
+        write_pod(f, run);
+        write_pod(f, summary);
+
+        write_pod(f, (int) with_colony);
+        if (with_colony) {
+            write_pod(f, colony.loop);
+            write_pod(f, colony.elapsed);
+            write_pod(f, colony.best_time);
+            write_pod(f, colony.best_loop);
+            write_pod(f, colony.best_vehicle_cost);
+            write_pod(f, colony.best_drone_cost);
+            write_pod(f, colony.restarts);
+            write_pod(f, colony.last_restart);
+            write_pod(f, colony.nAnts);
+            write_pod(f, colony.percent_drone_keeping);
+            write_pod(f, colony.rho);
+            write_pod(f, colony.tsp_rho);
+            write_pod(f, colony.controller);
+            write_pod(f, colony.granular);
+            write_vector(f, colony.phe);
+            write_pod(f, (int) colony.tsp_phe.size());
+            for (const vector<double> &row : colony.tsp_phe) write_vector(f, row);
+            write_vector(f, colony.best_vehicle.points);
+            write_pod(f, (int) colony.best_drone.node.size());
+            for (const vector<int> &vec : colony.best_drone.node) write_vector(f, vec);
+            fwrite(colony.rng, sizeof(uint64_t), 4, f);
+        }
+
+        bool ok = (fflush(f) == 0);
+        fclose(f);
+        if (!ok || rename(tmp_file.c_str(), file.c_str()) != 0) LOG_ERROR("Can not write checkpoint " << file);
+    }
+
+    /// save the colony of the current run
+    void save_colony() {
+        save(true);
+    }
+
+    /// save after a finished run, the next run starts from scratch
+    void save_summary() {
+        save(false);
+    }
+
+    /// why the job of the file differs from the current one, empty if it is the same
+    string mismatch(const Header &saved) {
+        if (saved.numPoint != header.numPoint) return "number of customers";
+        if (saved.instance != header.instance) return "coordinates or drone eligibility";
+        if (saved.numDrone != header.numDrone) return "number of drones";
+        if (saved.vehicle_speed != header.vehicle_speed) return "vehicle speed";
+        if (saved.drone_speed != header.drone_speed) return "drone speed";
+        if (saved.renumber != header.renumber) return "--renumber";
+        return "";
+    }
+
+    /// false if there is no usable checkpoint, exits if it belongs to another job
+    bool load() {
+        FILE *f = fopen(file.c_str(), "rb");
+        if (f == NULL) return false;
+        int numPoint = header.numPoint;
+
+        char magic[8];
+        Header saved;
+        int with_colony = 0;
+        bool ok = fread(magic, 1, sizeof(magic), f) == sizeof(magic) && memcmp(magic, MAGIC, sizeof(MAGIC)) == 0
+               && read_pod(f, saved);
+        string differs = ok ? mismatch(saved) : "";
+        if (!differs.empty()) {
+            /// starting over would overwrite the checkpoint of the other job
+            fclose(f);
+            LOG_ERROR("Checkpoint " << file << " belongs to another job: its " << differs << " differs");
+            exit(0);
+        }
+        ok = ok && read_pod(f, run) && read_pod(f, summary) && read_pod(f, with_colony);
+
+        if (ok && with_colony) {
+            int rows = 0, drones = 0;
+            ok = read_pod(f, colony.loop) && read_pod(f, colony.elapsed)
+              && read_pod(f, colony.best_time) && read_pod(f, colony.best_loop)
+              && read_pod(f, colony.best_vehicle_cost) && read_pod(f, colony.best_drone_cost)
+              && read_pod(f, colony.restarts) && read_pod(f, colony.last_restart)
+              && read_pod(f, colony.nAnts) && read_pod(f, colony.percent_drone_keeping)
+              && read_pod(f, colony.rho) && read_pod(f, colony.tsp_rho) && read_pod(f, colony.controller)
+              && read_pod(f, colony.granular)
+              && read_vector(f, colony.phe) && read_pod(f, rows) && rows == numPoint + 1;
+            colony.tsp_phe.resize(rows);
+            for (int i = 0; ok && i < rows; ++i) ok = read_vector(f, colony.tsp_phe[i]);
+            ok = ok && read_vector(f, colony.best_vehicle.points) && read_pod(f, drones) && drones >= 0;
+            colony.best_drone.node.resize(ok ? drones : 0);
+            for (int i = 0; ok && i < drones; ++i) ok = read_vector(f, colony.best_drone.node[i]);
+            ok = ok && fread(colony.rng, sizeof(uint64_t), 4, f) == 4;
+        }
+        fclose(f);
+
+        if (!ok) {
+            LOG_ERROR("Checkpoint " << file << " is invalid");
+            return false;
+        }
+        pending = with_colony && colony.loop > 0;
+        return true;
+    }
+}
+
+#endif
@@ -3,6 +3,8 @@
 
 #include "template.cpp"
 #include "constant.cpp"
+#include "logger.cpp"
+#include "exact_solver.cpp"
 
 namespace Config
 {
@@ -20,9 +22,39 @@ namespace Config
 
     double time_limit = 300.0;
     int loop_limit = 10000;
+    int runs = 10;
+    long long seed = 1;
 
     string output = "output/";
 
+    string trace;
+    bool found_trace = false;
+
+    int log_level = Logger::LEVEL_INFO;
+
+    string checkpoint;
+    bool found_checkpoint = false;
+    double checkpoint_interval = 30.0;
+    bool resume = false;
+
+    string initial_solution;
+    bool found_initial_solution = false;
+    double initial_bias = 0.5;
+
+    int exact_limit = Exact_Solver::MAX_CUSTOMERS;
+    double gap = 0;
+    int stagnation_stop = 0;
+    int restart = 0;
+    double restart_branching = 2.5;
+    bool adaptive = false;
+    double memo_cache = 0;
+    bool pms_improve = false;
+    int granular = 0;
+    string renumber = "none";
+
+    bool daemon = false;
+    int workers = 0; // 0: one per hardware thread
+
     string to_string(double val) {
         int tmp = (int) val;
         string ans = "";
@@ -76,6 +108,84 @@ namespace Config
                 loop_limit = val;
                 output += " Loop limit " + to_string(val);
             }
+            else if (key == "--runs") {
+                runs = stoi(argv[++i]);
+            }
+            else if (key == "--seed") {
+                seed = stoll(argv[++i]);
+            }
+            else if (key == "--trace") {
+                trace = argv[++i];
+                found_trace = true;
+            }
+            else if (key == "--checkpoint") {
+                checkpoint = argv[++i];
+                found_checkpoint = true;
+            }
+            else if (key == "--checkpoint-interval") {
+                checkpoint_interval = stof(argv[++i]);
+            }
+            else if (key == "--resume") {
+                resume = true;
+            }
+            else if (key == "--initial-solution") {
+                initial_solution = argv[++i];
+                found_initial_solution = true;
+            }
+            else if (key == "--initial-bias") {
+                initial_bias = stof(argv[++i]);
+            }
+            else if (key == "--exact-limit") {
+                exact_limit = stoi(argv[++i]);
+                if (exact_limit > Exact_Solver::MAX_CUSTOMERS) {
+                    cerr << "--exact-limit must be at most " << Exact_Solver::MAX_CUSTOMERS << "!\n";
+                    exit(0);
+                }
+            }
+            else if (key == "--gap") {
+                gap = stof(argv[++i]);
+            }
+            else if (key == "--stagnation-stop") {
+                stagnation_stop = stoi(argv[++i]);
+            }
+            else if (key == "--restart") {
+                restart = stoi(argv[++i]);
+            }
+            else if (key == "--restart-branching") {
+                restart_branching = stof(argv[++i]);
+            }
+            else if (key == "--adaptive") {
+                adaptive = true;
+            }
+            else if (key == "--memo-cache") {
+                memo_cache = stof(argv[++i]);
+            }
+            else if (key == "--pms-improve") {
+                pms_improve = true;
+            }
+            else if (key == "--granular") {
+                granular = stoi(argv[++i]);
+            }
+            else if (key == "--renumber") {
+                renumber = argv[++i];
+                if (renumber != "none" && renumber != "hilbert") {
+                    cerr << "Unknow renumbering " << renumber << "!\n";
+                    exit(0);
+                }
+            }
+            else if (key == "--daemon") {
+                daemon = true;
+            }
+            else if (key == "--workers") {
+                workers = stoi(argv[++i]);
+            }
+            else if (key == "--log-level") {
+                string value = argv[++i];
+                if (!Logger::parse_level(value, log_level)) {
+                    cerr << "Unknow log level " << value << "!\n";
+                    exit(0);
+                }
+            }
             else
             {
                 cerr << "Unknow argument " << argv[i] << "!\n";
@@ -83,11 +193,16 @@ namespace Config
             }
         }
 
-        if (!found_input)
+        if (!found_input && !daemon)
             {
                 cerr << "Input is required!\n";
                 exit(0);
             }
+        if (resume && !found_checkpoint)
+            {
+                cerr << "--resume requires --checkpoint!\n";
+                exit(0);
+            }
             // if (!found_customer)
             // {
             //     cerr << "Number of customers is required!\n";
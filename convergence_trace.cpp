@@ -0,0 +1,67 @@
+#ifndef PDSTSP_CONVERGENCE_TRACE
+#define PDSTSP_CONVERGENCE_TRACE
+
+#include "template.cpp"
+
+/*
+ * CSV trace of the colony convergence, one line per outer loop.
+ * Lines are collected in memory and written in large blocks.
+ */
+namespace Convergence_Trace
+{
+    const size_t BUFFER_SIZE = 1 << 16;
+
+    struct Writer {
+        FILE *file = NULL;
+        string buffer;
+        int run = 0;
+
+        bool enabled() const {
+            return file != NULL;
+        }
+
+        void flush() {
+            if (file == NULL || buffer.empty()) return;
+            fwrite(buffer.data(), 1, buffer.size(), file);
+            buffer.clear();
+        }
+
+        void open(const string &trace_file, bool append = false) {
+            file = fopen(trace_file.c_str(), append ? "a" : "w");
+            if (file == NULL) {
+                cerr << "Can not open trace file " << trace_file << "!\n";
+                exit(0);
+            }
+            buffer.reserve(BUFFER_SIZE + 320);
+            if (!append) buffer += "time,run,loop,best_vehicle_cost,best_drone_cost,best_cost,loop_vehicle_cost,loop_drone_cost,loop_best_cost,idle,branching,diversity\n";
+        }
+
+        void record(double time, int loop, double best_vehicle_cost, double best_drone_cost,
+                    double loop_vehicle_cost, double loop_drone_cost,
+                    int idle = 0, double branching = 0, double diversity = 0) {
+            if (file == NULL) return;
+
+            char line[320];
+            int len = snprintf(line, sizeof(line), "%.6f,%d,%d,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%d,%.4f,%.4f\n",
+                               time, run, loop,
+                               best_vehicle_cost, best_drone_cost, max(best_vehicle_cost, best_drone_cost),
+                               loop_vehicle_cost, loop_drone_cost, max(loop_vehicle_cost, loop_drone_cost),
+                               idle, branching, diversity);
+            buffer.append(line, len);
+
+            if (buffer.size() >= BUFFER_SIZE) flush();
+        }
+
+        void close() {
+            if (file == NULL) return;
+            flush();
+            fclose(file);
+            file = NULL;
+        }
+    };
+
+    /// trace of winter_main (--trace)
+    Writer trace;
+}
+
+#endif
@@ -0,0 +1,275 @@
+#ifndef PDSTSP_DAEMON
+#define PDSTSP_DAEMON
+
+#include "template.cpp"
+#include "json.cpp"
+#include "logger.cpp"
+#include "solver.cpp"
+#include "incremental.cpp"
+
+/*
+ * Long-lived solver: JSON-lines requests on stdin, one JSON-lines response per request
+ * on stdout, in completion order. Requests are solved by a pool of worker threads.
+ * Preprocessed instances and the last plan of each instance are kept in a cache, so
+ * repeated solves and deltas skip the file parsing and the distance matrix.
+ *
+ *   {"id": 1, "instance": "att48_0_80.csv", "drones": 2, "vehicle_speed": 1, "drone_speed": 2, "time_limit": 1}
+ *   {"id": 2, "key": "k", "points": [[x, y, drone_eligible], ...], "drones": 2, "time_limit": 1}
+ *   {"id": 3, "op": "delta", "key": "k", "add": [[x, y, drone_eligible]], "remove": [4, 7], "time_limit": 0.5}
+ *   {"id": 4, "op": "drop", "key": "k"}
+ *
+ * Optional fields: customers (default: the number in the file name), loop_limit, seed, gap, stagnation_stop, restart, adaptive, pms_improve, granular.
+ * Without "key", a file instance is cached under "<instance>|<drones>|<vehicle_speed>|<drone_speed>".
+ */
+namespace Daemon
+{
+    struct Entry {
+        mutex lock; // serializes the requests on the same instance
+        bool has_instance = false;
+        string source; // file and customer count the instance was read from, empty for inline points
+        tigersugar::Instance instance = tigersugar::Instance(0, 0, 0);
+        bool has_plan = false;
+        Incremental::Plan plan;
+    };
+
+    mutex cache_lock;
+    map<string, shared_ptr<Entry> > cache;
+
+    mutex queue_lock;
+    condition_variable queue_ready;
+    deque<string> requests;
+    bool closed = false;
+
+    mutex output_lock;
+
+    shared_ptr<Entry> find(const string &key, bool create) {
+        lock_guard<mutex> guard(cache_lock);
+        map<string, shared_ptr<Entry> >::iterator it = cache.find(key);
+        if (it != cache.end()) return it->second;
+        if (!create) return shared_ptr<Entry>();
+        shared_ptr<Entry> entry = make_shared<Entry>();
+        cache[key] = entry;
+        return entry;
+    }
+
+    void respond(const string &line) {
+        lock_guard<mutex> guard(output_lock);
+        cout << line << '\n';
+        cout.flush();
+    }
+
+    string error_response(const string &id, const string &message) {
+        return "{\"id\":" + id + ",\"error\":" + Json::quote(message) + "}";
+    }
+
+    string number(double val) {
+        char buf[32];
+        snprintf(buf, sizeof(buf), "%.10g", val);
+        return buf;
+    }
+
+    string ids(const vector<int> &vec) {
+        string res = "[";
+        REP(i, vec.size()) {
+            if (i) res += ",";
+            res += number(vec[i]);
+        }
+        return res + "]";
+    }
+
+    /// [[x, y, drone_eligible], ...]
+    bool read_customers(const Json::Value *val, vector<Incremental::Customer> &customers) {
+        if (val == NULL) return true;
+        if (val->type != Json::ARRAY) return false;
+        for (const Json::Value &row : val->array) {
+            if (row.type != Json::ARRAY || row.array.size() < 2) return false;
+            Incremental::Customer c;
+            c.x = row.array[0].number;
+            c.y = row.array[1].number;
+            c.drone_eligible = row.array.size() < 3
+                            || (row.array[2].type == Json::BOOLEAN ? row.array[2].boolean : row.array[2].number != 0);
+            customers.push_back(c);
+        }
+        return true;
+    }
+
+    int customers_of(const string &input) {
+        int customer = 0;
+        for (int i = 0; i < (int) input.size(); ++i)
+            if ( isdigit(input[i]) ) {
+                while ( isdigit(input[i]) ) customer = customer * 10 + input[i] - '0', ++i;
+                break;
+            }
+        return customer;
+    }
+
+    string plan_response(const string &id, const string &key, const Incremental::Plan &plan, double time, int loops,
+                         double lower_bound = 0, bool optimal = false, const string &stop = "") {
+        ostringstream out;
+        out << "{\"id\":" << id << ",\"key\":" << Json::quote(key)
+            << ",\"cost\":" << number(max(plan.vehicle_cost, plan.drone_cost))
+            << ",\"vehicle_cost\":" << number(plan.vehicle_cost)
+            << ",\"drone_cost\":" << number(plan.drone_cost)
+            << ",\"vehicle\":" << ids(plan.vehicle.points) << ",\"drones\":[";
+        REP(k, plan.drone.size()) out << (k ? "," : "") << ids(plan.drone.node[k]);
+        out << "],\"original_id\":" << ids(plan.original_id)
+            << ",\"time\":" << number(time) << ",\"loops\":" << loops
+            << ",\"lower_bound\":" << number(lower_bound) << ",\"optimal\":" << (optimal ? "true" : "false");
+        if (!stop.empty()) out << ",\"stop\":" << Json::quote(stop);
+        out << "}";
+        return out.str();
+    }
+
+    string solve(const Json::Value &request, const string &id) {
+        string file = request.get_string("instance", "");
+        int numDrone = (int) request.get_number("drones", 1);
+        double vSpeed = request.get_number("vehicle_speed", Constant::DEFAULT_VEHICLE_SPEED);
+        double dSpeed = request.get_number("drone_speed", Constant::DEFAULT_DRONE_SPEED);
+        const Json::Value *points = request.get("points");
+        if (file.empty() && points == NULL) return error_response(id, "instance or points is required");
+        if (numDrone < 0) return error_response(id, "drones must not be negative");
+
+        string key = request.get_string("key", "");
+        if (key.empty() && points != NULL) return error_response(id, "inline points require a key");
+        if (key.empty()) key = file + "|" + number(numDrone) + "|" + number(vSpeed) + "|" + number(dSpeed);
+
+        shared_ptr<Entry> entry = find(key, true);
+        lock_guard<mutex> guard(entry->lock);
+
+        Incremental::Plan &plan = entry->plan;
+        int num_customers = (int) request.get_number("customers", customers_of(file));
+        string source = points != NULL ? "" : file + "|" + number(num_customers);
+        bool changed = !entry->has_instance || source != entry->source || numDrone != plan.numDrone
+                    || vSpeed != plan.vehicle_speed || dSpeed != plan.drone_speed;
+        if (points != NULL || changed) {
+            plan.points.clear();
+            plan.drone_eligible.clear();
+            plan.original_id.clear();
+            if (points != NULL) {
+                vector<Incremental::Customer> customers;
+                if (!read_customers(points, customers) || customers.empty()) return error_response(id, "bad points");
+                for (const Incremental::Customer &c : customers) {
+                    plan.points.push_back(Point::point(c.x, c.y));
+                    plan.drone_eligible.push_back(c.drone_eligible);
+                }
+                plan.drone_eligible[0] = false;
+            }
+            else {
+                if (!Problem::read_points("data/" + file, num_customers, plan.points, plan.drone_eligible))
+                    return error_response(id, "can not read data/" + file);
+            }
+            REP(i, plan.points.size()) plan.original_id.push_back(i);
+            plan.numDrone = numDrone;
+            plan.vehicle_speed = vSpeed;
+            plan.drone_speed = dSpeed;
+            entry->instance = Input_Adaptation::Build(plan.points, plan.drone_eligible, numDrone, vSpeed, dSpeed);
+            entry->has_instance = true;
+            entry->source = source;
+            entry->has_plan = false;
+        }
+
+        Solver solver(entry->instance, (uint64_t) request.get_number("seed", 1));
+        solver.set_time_limit(request.get_number("time_limit", 1));
+        solver.set_loop_limit((int) request.get_number("loop_limit", entry->instance.loop_limit));
+        solver.parameters.gap = request.get_number("gap", solver.parameters.gap);
+        solver.parameters.stagnation_stop = (int) request.get_number("stagnation_stop", solver.parameters.stagnation_stop);
+        solver.parameters.restart = (int) request.get_number("restart", solver.parameters.restart);
+        solver.parameters.granular = (int) request.get_number("granular", solver.parameters.granular);
+        const Json::Value *adaptive = request.get("adaptive");
+        if (adaptive != NULL && adaptive->type == Json::BOOLEAN) solver.parameters.adaptive = adaptive->boolean;
+        const Json::Value *pms_improve = request.get("pms_improve");
+        if (pms_improve != NULL && pms_improve->type == Json::BOOLEAN) solver.parameters.pms_improve = pms_improve->boolean;
+        const ACO_solution::Result &res = solver.solve();
+
+        plan.vehicle = res.vehicle;
+        plan.drone = res.drone;
+        plan.drone.node.resize(numDrone); /// the split keeps one (empty) drone list without drones
+        plan.vehicle_cost = res.vehicle.distance(entry->instance);
+        plan.drone_cost = plan.drone.distance(entry->instance);
+        entry->has_plan = true;
+        return plan_response(id, key, plan, res.elapsed, res.num_loop, res.lower_bound, res.optimal, res.stop);
+    }
+
+    string delta(const Json::Value &request, const string &id) {
+        string key = request.get_string("key", "");
+        shared_ptr<Entry> entry = find(key, false);
+        if (!entry) return error_response(id, "unknown key " + key);
+        lock_guard<mutex> guard(entry->lock);
+        if (!entry->has_plan) return error_response(id, "no plan to update for " + key);
+
+        Incremental::Delta change;
+        if (!read_customers(request.get("add"), change.added)) return error_response(id, "bad add");
+        const Json::Value *removed = request.get("remove");
+        if (removed != NULL) for (const Json::Value &x : removed->array) change.removed.push_back((int) x.number);
+
+        double start = ACO_solution::cpu_time();
+        Rng::seed_stream((uint64_t) request.get_number("seed", 1), 1);
+        ACO_solution::Result phase;
+        entry->plan = Incremental::apply(entry->plan, change, request.get_number("time_limit", 1), &entry->instance, &phase);
+        return plan_response(id, key, entry->plan, ACO_solution::cpu_time() - start, phase.num_loop,
+                             phase.lower_bound, phase.optimal, phase.stop);
+    }
+
+    string handle(const string &line) {
+        Json::Value request;
+        string error;
+        if (!Json::parse(line, request, error)) return error_response("null", error);
+        if (request.type != Json::OBJECT) return error_response("null", "request must be an object");
+
+        const Json::Value *id_val = request.get("id");
+        string id = "null";
+        if (id_val != NULL && id_val->type == Json::NUMBER) id = number(id_val->number);
+        if (id_val != NULL && id_val->type == Json::STRING) id = Json::quote(id_val->str);
+
+        string op = request.get_string("op", "solve");
+        if (op == "solve") return solve(request, id);
+        if (op == "delta") return delta(request, id);
+        if (op == "drop") {
+            lock_guard<mutex> guard(cache_lock);
+            bool found = cache.erase(request.get_string("key", "")) > 0;
+            return "{\"id\":" + id + ",\"dropped\":" + (found ? "true" : "false") + "}";
+        }
+        return error_response(id, "unknown op " + op);
+    }
+
+    void worker() {
+        while (true) {
+            string line;
+            {
+                unique_lock<mutex> guard(queue_lock);
+                queue_ready.wait(guard, [] { return closed || !requests.empty(); });
+                if (requests.empty()) return;
+                line = requests.front();
+                requests.pop_front();
+            }
+            respond(handle(line));
+        }
+    }
+
+    /// serve until stdin is closed, the pending requests are finished before returning
+    void serve(int workers) {
+        if (workers <= 0) workers = max(1, (int) thread::hardware_concurrency());
+        LOG_INFO("Daemon started with " << workers << " workers");
+
+        vector<thread> pool;
+        REP(i, workers) pool.push_back(thread(worker));
+
+        string line;
+        while (getline(cin, line)) {
+            if (line.find_first_not_of(" \t\r") == string::npos) continue;
+            lock_guard<mutex> guard(queue_lock);
+            requests.push_back(line);
+            queue_ready.notify_one();
+        }
+
+        {
+            lock_guard<mutex> guard(queue_lock);
+            closed = true;
+        }
+        queue_ready.notify_all();
+        REP(i, pool.size()) pool[i].join();
+        LOG_INFO("Daemon stopped");
+    }
+}
+
+#endif
@@ -1,6 +1,11 @@
+#ifndef PDSTSP_DP_SPLIT_TOUR
+#define PDSTSP_DP_SPLIT_TOUR
+
 #include "paper/utilities.cpp"
 #include "paper/tsp_optimizer.cpp"
 #include "paper/pms_optimizer.cpp"
+#include "rng.cpp"
+#include "arena.cpp"
 
 namespace dynamic_programming_split_tour {
     #define limitPer 100
@@ -14,7 +19,7 @@ namespace dynamic_programming_split_tour {
         return false;
     }
 
-    void Build_Graph(const tigersugar::Instance &instance, vector<int> &V, vector<vector<int> > &adj, vector<double> &S2) {
+    void Build_Graph(const tigersugar::Instance &instance, Arena::Vector<int> &V, Arena::Vector<Arena::Vector<int> > &adj, Arena::Vector<double> &S2) {
         int n = V.size();
         adj.clear(); adj.resize(n);
         S2.clear(); S2.resize(n);
@@ -23,6 +28,10 @@ namespace dynamic_programming_split_tour {
             bool flag_eligible = true;
             S2[i] = (i == 0) ? instance.drone_cost[V[i]] : S2[i-1] + instance.drone_cost[V[i]];
 
+            int end = i+1; /// the edges stop after the first customer the drone can not serve
+            while (end < n - 1 && instance.drone_cost[V[end]]) ++end;
+            if (end < n) adj[i].reserve(end - i);
+
             FOR(j, i+1, V.size()-1) {
                 if ( !flag_eligible ) break;
                 if ( !instance.drone_cost[V[j]] ) flag_eligible = false;
@@ -31,26 +40,46 @@ namespace dynamic_programming_split_tour {
         }
     }
 
-    double get_S2(const vector<double> &S2, int numDrone, int u, int v) {
+    /// candidate end state of the dp, ordered by its lower bound
+    struct Candidate {
+        int last_per;
+        double vehicle_cost, drone_bound, bound;
+        uint64_t hash; /// Zobrist hash of the drone set
+
+        bool operator < (const Candidate &other) const {
+            if (bound != other.bound) return bound < other.bound;
+            return last_per < other.last_per;
+        }
+    };
+
+    double get_S2(const Arena::Vector<double> &S2, int numDrone, int u, int v) {
         ++u; --v;
         if (u > v) return 0;
         if (u == 0) return S2[v];
         return (S2[v] - S2[u-1]) / (double) numDrone; 
     }
 
-    void split(tigersugar::Instance &instance, tigersugar::Tour &vehicle, tigersugar::Drone_Tour &drone, vector<pair<double, int> > &drone_keeping, double best_cost) {  
+    /// tours of split, per thread: the result is swapped with the caller's tours, so both keep their memory
+    struct Scratch {
+        tigersugar::Tour ore_vehicle, cur_vehicle;
+        tigersugar::Drone_Tour ore_drone, cur_drone;
+    };
+
+    thread_local Scratch scratch;
+
+    void split(tigersugar::Instance &instance, tigersugar::Tour &vehicle, tigersugar::Drone_Tour &drone, vector<pair<double, int> > &drone_keeping, double best_cost, bool pms_improve = false) {  
         assert( drone.node.empty() );
-        drone.node.resize(1);
+        drone.add_drone();
+        Arena::Scope scope;
 
-        vector<int> V;
-        for (int x : vehicle.points) V.push_back(x);
+        Arena::Vector<int> V(vehicle.points.begin(), vehicle.points.end());
 
-        vector<double> S2;
-        vector<vector<int> > adj;
+        Arena::Vector<double> S2;
+        Arena::Vector<Arena::Vector<int> > adj;
         Build_Graph(instance, V, adj, S2);
 
-        vector<vector<double> > dp;
-        vector<vector<pair<int, int> > > Trace;
+        Arena::Vector<Arena::Vector<double> > dp;
+        Arena::Vector<Arena::Vector<pair<int, int> > > Trace;
         dp.resize(V.size());
         Trace.resize(V.size());
         FOR(i, 0, (int) V.size()-1) {
@@ -73,20 +102,67 @@ namespace dynamic_programming_split_tour {
             }
         }
 
-        tigersugar::Tour ore_vehicle = vehicle;
-        tigersugar::Drone_Tour ore_drone = drone;
+        tigersugar::Tour &ore_vehicle = scratch.ore_vehicle;
+        tigersugar::Drone_Tour &ore_drone = scratch.ore_drone;
+        ore_vehicle = vehicle;
+        ore_drone.resize_drones(1);
+        ore_drone.node[0].clear();
         for (auto x : drone_keeping) ore_drone.node[0].push_back(x.second);
-        pms_optimizer::optimizeTour(instance, ore_drone);
+        pms_optimizer::optimizeTour(instance, ore_drone, pms_improve);
         double ore_cost = max( vehicle.distance(instance), ore_drone.distance(instance) );
 
-        FOR(last_per, 0, limitPer) {    
-            int per = last_per, i = (int) V.size()-1;
-            if (dp[i][per] >= ORE_INFINITY + 1e-9) continue;
+        /// candidates: vehicle cost read from dp, drone set hashed and bounded while walking the trace
+        double keep_load = 0, keep_max = 0;
+        for (auto x : drone_keeping) {
+            keep_load += instance.drone_cost[x.second];
+            keep_max = max(keep_max, instance.drone_cost[x.second]);
+        }
 
-            tigersugar::Tour cur_vehicle;
-            tigersugar::Drone_Tour cur_drone;
+        int last = (int) V.size()-1;
+        Arena::Vector<Candidate> candidates;
+        candidates.reserve(limitPer+1);
+        FOR(last_per, 0, limitPer) {
+            if (dp[last][last_per] >= ORE_INFINITY + 1e-9) continue;
+
+            Candidate c;
+            c.last_per = last_per;
+            c.vehicle_cost = dp[last][last_per];
+            c.hash = 0;
+            double load = keep_load, largest = keep_max;
+            int per = last_per, i = last;
+            while (i > 0) {
+                pair<int, int> foo = Trace[i][per];
+                FOR(p, foo.first+1, i-1) if (V[p] != 0) {
+                    c.hash ^= Rng::zobrist(V[p]);
+                    load += instance.drone_cost[V[p]];
+                    largest = max(largest, instance.drone_cost[V[p]]);
+                }
+                i = foo.first; per = foo.second;
+            }
+            c.drone_bound = max(largest, instance.numDrone > 0 ? load / instance.numDrone : load);
+            c.bound = max(c.vehicle_cost, c.drone_bound);
+            candidates.push_back(c);
+        }
+        sort(candidates.begin(), candidates.end());
+
+        /// evaluate in bound order, stop once no candidate can beat the incumbent
+        int ore_per = -1;
+        Arena::Vector<uint64_t> seen;
+        seen.reserve(candidates.size());
+        /// buffers of the candidate, swapped with ore_ when it is better
+        tigersugar::Tour &cur_vehicle = scratch.cur_vehicle;
+        tigersugar::Drone_Tour &cur_drone = scratch.cur_drone;
+        for (const Candidate &c : candidates) {
+            if (c.bound > ore_cost + 1e-9) break;
+            if (c.drone_bound >= ore_cost + 1e-9) continue;
+            if (find(seen.begin(), seen.end(), c.hash) != seen.end()) continue; /// same drone set, same split
+            seen.push_back(c.hash);
+
+            int per = c.last_per, i = last;
+            cur_vehicle.points.clear();
             cur_vehicle.points.push_back(0);
-            cur_drone.node.resize(1);
+            cur_drone.resize_drones(1);
+            cur_drone.node[0].clear();
             for (auto x : drone_keeping) cur_drone.node[0].push_back(x.second);
 
             /// trace back
@@ -101,24 +177,26 @@ namespace dynamic_programming_split_tour {
             assert(cur_vehicle.points[0] == 0 && cur_vehicle.points.back() == 0);
 
             /// optimize tour for drone
-            pms_optimizer::optimizeTour(instance, cur_drone);
+            pms_optimizer::optimizeTour(instance, cur_drone, pms_improve);
             
             double drone_cost = cur_drone.distance(instance);
             if (drone_cost >= ore_cost + 1e-9) continue;
-            
-            /// optimize tour for vehicle
-            //tsp_optimizer::optimizeTour(instance, cur_vehicle);
-            double vehicle_cost = cur_vehicle.distance(instance);
-
-            /// update result
-            if ( max(drone_cost, vehicle_cost) + 1e-9 < ore_cost ) {
-                ore_cost = max(drone_cost, vehicle_cost);
-                ore_vehicle = cur_vehicle;
-                ore_drone = cur_drone;
+            double cost = max(drone_cost, c.vehicle_cost);
+
+            /// update result, ties go to the smallest last_per as in a scan by last_per
+            bool better = cost + 1e-9 < ore_cost;
+            bool tie = ore_per >= 0 && fabs(cost - ore_cost) <= 1e-9 && c.last_per < ore_per;
+            if (better || tie) {
+                ore_cost = cost;
+                ore_per = c.last_per;
+                swap(ore_vehicle, cur_vehicle);
+                swap(ore_drone, cur_drone);
             }
         }
 
-        vehicle = ore_vehicle;
-        drone = ore_drone;
+        swap(vehicle, ore_vehicle);
+        swap(drone, ore_drone);
     }
-}
\ No newline at end of file
+}
+
+#endif
@@ -0,0 +1,149 @@
+#ifndef PDSTSP_EXACT_SOLVER
+#define PDSTSP_EXACT_SOLVER
+
+#include "paper/utilities.cpp"
+#include "thread_clock.cpp"
+
+/*
+ * Exact solver for small instances. Held-Karp gives the shortest vehicle tour T[V] of every
+ * customer set V, a subset DP gives the optimal makespan P[D] of every drone set D on the
+ * numDrone drones, and the optimum is min over the partitions (V, D) of max(T[V], P[D]).
+ * Time O(2^n n^2 + numDrone 3^e), e the number of drone eligible customers, memory O(2^n n).
+ * MAX_CUSTOMERS keeps both within a few seconds and 8 MB; the subset loops also watch a time
+ * limit (thread CPU time, as the colony) and give up, leaving the instance to the colony.
+ */
+namespace Exact_Solver
+{
+    const int MAX_CUSTOMERS = 16;
+    const double EPS = 1e-9;
+    const double INF = 1e18;
+    const int CLOCK_MASK = (1 << 10) - 1; /// the time is checked every 1024 subsets
+
+    struct Solution {
+        double cost = -1;
+        tigersugar::Tour vehicle;
+        tigersugar::Drone_Tour drone;
+    };
+
+    /// returns false if the instance has more than max_customers customers or time_limit seconds ran out
+    bool solve(const tigersugar::Instance &instance, Solution &sol, int max_customers = MAX_CUSTOMERS,
+               double time_limit = INF) {
+        int n = instance.numPoint;
+        if (n > min(max_customers, MAX_CUSTOMERS)) return false;
+        double start = Thread_Clock::cpu_time(); /// the clock of the colony budget the limit is taken from
+        auto expired = [&] () { return Thread_Clock::cpu_time() - start > time_limit; };
+        const vector<vector<double> > &d = instance.distance;
+        int full = (1 << n) - 1;
+
+        /// f[S][j]: shortest path from the depot through the customers of S, ending at j (customer j+1)
+        vector<double> f((size_t) (full + 1) * max(n, 1), INF);
+        REP(j, n) f[(size_t) (1 << j) * n + j] = d[0][j+1];
+        FOR(S, 1, full) REP(j, n) {
+            if (j == 0 && (S & CLOCK_MASK) == 0 && expired()) return false;
+            double cur = f[(size_t) S * n + j];
+            if (!BIT(S, j) || cur >= INF) continue;
+            REP(k, n) if (!BIT(S, k)) {
+                double &nxt = f[(size_t) (S | 1 << k) * n + k];
+                nxt = min(nxt, cur + d[j+1][k+1]);
+            }
+        }
+        vector<double> tour(full + 1, INF);
+        tour[0] = 0;
+        FOR(S, 1, full) REP(j, n) if (BIT(S, j))
+            tour[S] = min(tour[S], f[(size_t) S * n + j] + d[j+1][0]);
+
+        /// drone eligible customers, compacted
+        vector<int> eligible;
+        int forced = 0; // customers the vehicle must serve
+        REP(j, n) {
+            if (instance.drone_cost[j+1] > 1e-9) eligible.push_back(j);
+            else forced |= 1 << j;
+        }
+        int e = eligible.size(), all = (1 << e) - 1;
+        int m = instance.numDrone;
+
+        vector<double> load(all + 1, 0);
+        FOR(D, 1, all) {
+            int low = __builtin_ctz(D);
+            load[D] = load[D & (D-1)] + instance.drone_cost[eligible[low] + 1];
+        }
+
+        /// span[k][D]: optimal makespan of D on k+1 drones, take[k][D]: set of the drone holding the lowest customer
+        vector<vector<double> > span;
+        vector<vector<int> > take;
+        if (m > 0) {
+            span.push_back(load);
+            take.push_back(vector<int>(all + 1));
+            FOR(D, 0, all) take[0][D] = D;
+        }
+        FOR(k, 1, min(m, e) - 1) {
+            span.push_back(vector<double>(all + 1, 0));
+            take.push_back(vector<int>(all + 1, 0));
+            const vector<double> &prv = span[k-1];
+            vector<double> &cur = span[k];
+            FOR(D, 1, all) {
+                if ((D & CLOCK_MASK) == 0 && expired()) return false;
+                int low = D & -D, rest = D ^ low;
+                cur[D] = INF;
+                /// the drone holding the lowest customer takes low + sub, the other k drones the rest
+                for (int sub = rest; ; sub = (sub - 1) & rest) {
+                    double val = max(load[low | sub], prv[rest ^ sub]);
+                    if (val < cur[D]) { cur[D] = val; take[k][D] = low | sub; }
+                    if (sub == 0) break;
+                }
+            }
+        }
+
+        /// best partition
+        int best_vehicle = -1, best_drone = 0;
+        double best = INF;
+        FOR(V, 0, full) {
+            if ((V & forced) != forced || tour[V] >= INF) continue;
+            int D = 0;
+            REP(i, e) if (!BIT(V, eligible[i])) D |= 1 << i;
+            double drone_span = 0;
+            if (D != 0) {
+                if (m == 0) continue;
+                drone_span = span.back()[D];
+            }
+            double val = max(tour[V], drone_span);
+            if (val < best - EPS) { best = val; best_vehicle = V; best_drone = D; }
+        }
+        if (best_vehicle < 0) return false;
+
+        /// rebuild the vehicle tour backward
+        vector<int> order;
+        int S = best_vehicle, last = -1;
+        while (S != 0) {
+            int pick = -1;
+            REP(j, n) if (BIT(S, j)) {
+                double to = (last < 0) ? d[j+1][0] : d[j+1][last+1];
+                double target = (last < 0) ? tour[S] : f[(size_t) (S | 1 << last) * n + last];
+                if (fabs(f[(size_t) S * n + j] + to - target) < 1e-6 * max(1.0, target)) { pick = j; break; }
+            }
+            if (pick < 0) pick = __builtin_ctz(S);
+            order.push_back(pick);
+            last = pick;
+            S ^= 1 << pick;
+        }
+
+        sol.cost = best;
+        sol.vehicle = tigersugar::Tour();
+        sol.vehicle.add(0);
+        FORD(i, (int) order.size() - 1, 0) sol.vehicle.add(order[i] + 1);
+        sol.vehicle.add(0);
+
+        sol.drone = tigersugar::Drone_Tour();
+        REP(k, m) sol.drone.add_drone();
+        int D = best_drone;
+        FORD(k, (int) span.size() - 1, 0) {
+            if (D == 0) break;
+            int part = take[k][D];
+            REP(i, e) if (BIT(part, i)) sol.drone.node[k].push_back(eligible[i] + 1);
+            D ^= part;
+        }
+        return true;
+    }
+}
+
+#endif
@@ -0,0 +1,163 @@
+#ifndef PDSTSP_INCREMENTAL
+#define PDSTSP_INCREMENTAL
+
+#include "template.cpp"
+#include "point.cpp"
+#include "problem.cpp"
+#include "paper_Input_adaptation.cpp"
+#include "ACO_solution.cpp"
+
+/*
+ * Re-optimization of an existing plan after customers are added or cancelled.
+ * The plan is repaired by cheapest insertion, improved by the local search and
+ * then by a short ACO phase started from the repaired plan.
+ *
+ * Customer ids are compacted: remaining customers keep their order, added customers
+ * are appended after them. Plan::original_id maps the ids back to the caller's ids.
+ */
+namespace Incremental
+{
+    struct Customer {
+        double x, y;
+        bool drone_eligible;
+    };
+
+    struct Delta {
+        vector<Customer> added;
+        vector<int> removed; // ids in the current plan
+    };
+
+    struct Plan {
+        vector<Point::point> points; // points[0] is the depot
+        vector<bool> drone_eligible;
+        int numDrone;
+        double vehicle_speed, drone_speed;
+
+        tigersugar::Tour vehicle;
+        tigersugar::Drone_Tour drone;
+        double vehicle_cost, drone_cost;
+
+        /// id of every customer before the first delta, -1 for customers added later
+        vector<int> original_id;
+    };
+
+    /// plan of the last winter_main / ACO_solution run on the instance loaded in Problem
+    Plan from_problem() {
+        Plan plan;
+        plan.points = Problem::points;
+        REP(i, Problem::dCost.size()) plan.drone_eligible.push_back(Problem::dCost[i] != Constant::INF);
+        plan.numDrone = Problem::m;
+        plan.vehicle_speed = Problem::vehicle_speed;
+        plan.drone_speed = Problem::drone_speed;
+        plan.vehicle.points = Problem::vTour;
+        plan.drone.node = Problem::dTour;
+        REP(i, plan.points.size()) plan.original_id.push_back(i);
+        return plan;
+    }
+
+    /// insert x where it increases the makespan the least: cheapest vehicle position or least loaded drone
+    void insert(const tigersugar::Instance &instance, tigersugar::Tour &vehicle, tigersugar::Drone_Tour &drone, int x) {
+        double vehicle_cost = vehicle.distance(instance);
+
+        int best_pos = 1;
+        double best_delta = ORE_INFINITY;
+        FOR(i, 0, vehicle.size()-2) {
+            int u = vehicle[i], v = vehicle[i+1];
+            double delta = instance.distance[u][x] + instance.distance[x][v] - instance.distance[u][v];
+            if (delta < best_delta) { best_delta = delta; best_pos = i+1; }
+        }
+
+        vector<double> load(drone.size(), 0);
+        double drone_cost = 0;
+        int least = 0;
+        REP(k, drone.size()) {
+            for (int y : drone.node[k]) load[k] += instance.drone_cost[y];
+            drone_cost = max(drone_cost, load[k]);
+            if (load[k] < load[least]) least = k;
+        }
+
+        double by_vehicle = max(vehicle_cost + best_delta, drone_cost);
+        bool eligible = instance.drone_cost[x] > 1e-9 && drone.size() > 0;
+        if (eligible && max(vehicle_cost, max(drone_cost, load[least] + instance.drone_cost[x])) < by_vehicle)
+            drone.node[least].push_back(x);
+        else
+            vehicle.points.insert(vehicle.points.begin() + best_pos, x);
+    }
+
+    /// apply the delta to the plan, then repair and re-optimize it within time_budget seconds.
+    /// built receives the instance of the new plan and phase the result of the ACO phase, when given
+    Plan apply(const Plan &plan, const Delta &delta, double time_budget,
+               tigersugar::Instance *built = NULL, ACO_solution::Result *phase = NULL) {
+        int n = (int) plan.points.size() - 1;
+        vector<bool> removed(n+1, false);
+        for (int x : delta.removed) if (x > 0 && x <= n) removed[x] = true;
+
+        /// compact the ids
+        Plan res;
+        res.numDrone = plan.numDrone;
+        res.vehicle_speed = plan.vehicle_speed;
+        res.drone_speed = plan.drone_speed;
+
+        vector<int> new_id(n+1, -1);
+        FOR(i, 0, n) if (!removed[i]) {
+            new_id[i] = (int) res.points.size();
+            res.points.push_back(plan.points[i]);
+            res.drone_eligible.push_back(plan.drone_eligible[i]);
+            res.original_id.push_back(plan.original_id[i]);
+        }
+        vector<int> added;
+        for (const Customer &c : delta.added) {
+            added.push_back((int) res.points.size());
+            res.points.push_back(Point::point(c.x, c.y));
+            res.drone_eligible.push_back(c.drone_eligible);
+            res.original_id.push_back(-1);
+        }
+
+        tigersugar::Instance instance = Input_Adaptation::Build(res.points, res.drone_eligible, res.numDrone,
+                                                                res.vehicle_speed, res.drone_speed);
+        instance.time_limit = time_budget;
+
+        for (int x : plan.vehicle.points) if (new_id[x] >= 0) res.vehicle.add(new_id[x]);
+        vector<int> orphans; // drone customers of a drone the fleet does not have (a plan without drones keeps an empty one)
+        res.drone.node.resize(res.numDrone);
+        REP(k, plan.drone.size())
+            for (int x : plan.drone.node[k]) if (new_id[x] >= 0) {
+                if (k < res.numDrone) res.drone.node[k].push_back(new_id[x]);
+                else orphans.push_back(new_id[x]);
+            }
+
+        /// repair
+        for (int x : orphans) insert(instance, res.vehicle, res.drone, x);
+        for (int x : added) insert(instance, res.vehicle, res.drone, x);
+        if (res.vehicle.size() > 3) tsp_optimizer::optimizeTour(instance, res.vehicle);
+        local_search::descend(instance, res.vehicle, res.drone);
+
+        /// short ACO phase from the repaired plan
+        ACO_solution::Result result;
+        result.stop = "time";
+        if (time_budget > 0) {
+            ACO_solution::Initial_Solution initial;
+            initial.enabled = true;
+            initial.bias = ACO_solution::initial.bias;
+            initial.vehicle = res.vehicle;
+            initial.drone = res.drone;
+
+            ACO_solution::Context context;
+            context.param = ACO_solution::default_parameters(instance);
+            context.initial = &initial;
+
+            result = ACO_solution::solve(instance, context);
+            res.vehicle = result.vehicle;
+            res.drone = result.drone;
+        }
+        else result.lower_bound = Lower_Bound::makespan(instance);
+
+        res.vehicle_cost = res.vehicle.distance(instance);
+        res.drone_cost = res.drone.distance(instance);
+        if (phase != NULL) *phase = result;
+        if (built != NULL) *built = instance;
+        return res;
+    }
+}
+
+#endif
@@ -0,0 +1,190 @@
+#ifndef PDSTSP_JSON
+#define PDSTSP_JSON
+
+#include "template.cpp"
+
+/*
+ * Minimal JSON reader for the daemon protocol: one document per line, no streaming.
+ * Numbers are doubles, object members keep their order.
+ */
+namespace Json
+{
+    enum Type { NUL, BOOLEAN, NUMBER, STRING, ARRAY, OBJECT };
+
+    struct Value {
+        Type type = NUL;
+        bool boolean = false;
+        double number = 0;
+        string str;
+        vector<Value> array;
+        vector<pair<string, Value> > object;
+
+        /// member `key` of an object, NULL if missing
+        const Value *get(const string &key) const {
+            for (const pair<string, Value> &member : object)
+                if (member.first == key) return &member.second;
+            return NULL;
+        }
+
+        double get_number(const string &key, double fallback) const {
+            const Value *val = get(key);
+            return (val != NULL && val->type == NUMBER) ? val->number : fallback;
+        }
+
+        string get_string(const string &key, const string &fallback) const {
+            const Value *val = get(key);
+            return (val != NULL && val->type == STRING) ? val->str : fallback;
+        }
+    };
+
+    struct Parser {
+        const string &text;
+        size_t pos;
+        string error;
+
+        Parser(const string &_text) : text(_text), pos(0) {}
+
+        void skip_space() {
+            while (pos < text.size() && isspace((unsigned char) text[pos])) ++pos;
+        }
+
+        bool fail(const string &msg) {
+            if (error.empty()) {
+                char where[32];
+                snprintf(where, sizeof(where), " at offset %d", (int) pos);
+                error = msg + where;
+            }
+            return false;
+        }
+
+        bool expect(const char *word) {
+            size_t len = strlen(word);
+            if (text.compare(pos, len, word) != 0) return fail("unexpected token");
+            pos += len;
+            return true;
+        }
+
+        bool parse_string(string &out) {
+            if (pos >= text.size() || text[pos] != '"') return fail("expected string");
+            ++pos;
+            out.clear();
+            while (pos < text.size() && text[pos] != '"') {
+                char c = text[pos++];
+                if (c != '\\') { out += c; continue; }
+                if (pos >= text.size()) break;
+                char e = text[pos++];
+                switch (e) {
+                    case 'n': out += '\n'; break;
+                    case 't': out += '\t'; break;
+                    case 'r': out += '\r'; break;
+                    case 'b': out += '\b'; break;
+                    case 'f': out += '\f'; break;
+                    case 'u': {
+                        if (pos + 4 > text.size()) return fail("bad escape");
+                        unsigned code = strtoul(text.substr(pos, 4).c_str(), NULL, 16);
+                        pos += 4;
+                        if (code < 0x80) out += (char) code;
+                        else if (code < 0x800) { out += (char) (0xC0 | (code >> 6)); out += (char) (0x80 | (code & 0x3F)); }
+                        else { out += (char) (0xE0 | (code >> 12)); out += (char) (0x80 | ((code >> 6) & 0x3F)); out += (char) (0x80 | (code & 0x3F)); }
+                        break;
+                    }
+                    default: out += e;
+                }
+            }
+            if (pos >= text.size()) return fail("unterminated string");
+            ++pos;
+            return true;
+        }
+
+        bool parse_value(Value &val, int depth) {
+            if (depth > 64) return fail("nesting too deep");
+            skip_space();
+            if (pos >= text.size()) return fail("unexpected end");
+
+            char c = text[pos];
+            if (c == '{') {
+                val.type = OBJECT;
+                ++pos;
+                skip_space();
+                if (pos < text.size() && text[pos] == '}') { ++pos; return true; }
+                while (true) {
+                    skip_space();
+                    string key;
+                    if (!parse_string(key)) return false;
+                    skip_space();
+                    if (pos >= text.size() || text[pos] != ':') return fail("expected ':'");
+                    ++pos;
+                    val.object.push_back(make_pair(key, Value()));
+                    if (!parse_value(val.object.back().second, depth + 1)) return false;
+                    skip_space();
+                    if (pos < text.size() && text[pos] == ',') { ++pos; continue; }
+                    if (pos < text.size() && text[pos] == '}') { ++pos; return true; }
+                    return fail("expected ',' or '}'");
+                }
+            }
+            if (c == '[') {
+                val.type = ARRAY;
+                ++pos;
+                skip_space();
+                if (pos < text.size() && text[pos] == ']') { ++pos; return true; }
+                while (true) {
+                    val.array.push_back(Value());
+                    if (!parse_value(val.array.back(), depth + 1)) return false;
+                    skip_space();
+                    if (pos < text.size() && text[pos] == ',') { ++pos; continue; }
+                    if (pos < text.size() && text[pos] == ']') { ++pos; return true; }
+                    return fail("expected ',' or ']'");
+                }
+            }
+            if (c == '"') {
+                val.type = STRING;
+                return parse_string(val.str);
+            }
+            if (c == 't') { val.type = BOOLEAN; val.boolean = true; return expect("true"); }
+            if (c == 'f') { val.type = BOOLEAN; val.boolean = false; return expect("false"); }
+            if (c == 'n') { val.type = NUL; return expect("null"); }
+
+            const char *begin = text.c_str() + pos;
+            char *end;
+            val.type = NUMBER;
+            val.number = strtod(begin, &end);
+            if (end == begin) return fail("unexpected character");
+            pos += end - begin;
+            return true;
+        }
+    };
+
+    /// returns false and sets error if line is not a single JSON document
+    bool parse(const string &line, Value &val, string &error) {
+        Parser parser(line);
+        bool ok = parser.parse_value(val, 0);
+        parser.skip_space();
+        if (ok && parser.pos != line.size()) ok = parser.fail("trailing characters");
+        error = parser.error;
+        return ok;
+    }
+
+    /// string literal with escapes
+    string quote(const string &s) {
+        string res = "\"";
+        for (char c : s) {
+            switch (c) {
+                case '"': res += "\\\""; break;
+                case '\\': res += "\\\\"; break;
+                case '\n': res += "\\n"; break;
+                case '\t': res += "\\t"; break;
+                case '\r': res += "\\r"; break;
+                default:
+                    if ((unsigned char) c < 0x20) {
+                        char buf[8];
+                        snprintf(buf, sizeof(buf), "\\u%04x", c);
+                        res += buf;
+                    }
+                    else res += c;
+            }
+        }
+        return res + "\"";
+    }
+}
+
+#endif
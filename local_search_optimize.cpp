@@ -1,3 +1,6 @@
+#ifndef PDSTSP_LOCAL_SEARCH
+#define PDSTSP_LOCAL_SEARCH
+
 #include "paper/utilities.cpp"
 
 namespace local_search {
@@ -116,11 +119,143 @@ namespace local_search {
         return flag_optimize;
     }
 
-    bool optimize_drone(tigersugar::Instance &instance, tigersugar::Drone_Tour &drone) {
+    /*
+     * Specializations for fleets of 1..MAX_FIXED_DRONES drones, the sizes of all our runs: drone
+     * loads live in fixed arrays, loops over the drones have a compile-time trip count, and the
+     * best move is recorded and applied once instead of copying the tours on every improvement.
+     * optimize_drone and optimize dispatch on drone.node.size(), larger fleets take the generic code.
+     */
+    const int MAX_FIXED_DRONES = 5;
+
+    template<int M>
+    void drone_loads(const tigersugar::Instance &instance, const tigersugar::Drone_Tour &drone, double (&load)[M]) {
+        REP(k, M) {
+            load[k] = 0;
+            for (int x : drone.node[k]) load[k] += instance.drone_cost[x];
+        }
+    }
+
+    template<int M>
+    bool optimize_drone_fixed(tigersugar::Instance &instance, tigersugar::Drone_Tour &drone) {
+        if (M <= 1) return false;
+
+        double save_drone[M];
+        drone_loads<M>(instance, drone, save_drone);
+
+        double maxDrone[3] = { -1, -1, -1 };
+        REP(i, M) {
+            if (save_drone[i] >= maxDrone[0]) {
+                maxDrone[2] = maxDrone[1];
+                maxDrone[1] = maxDrone[0];
+                maxDrone[0] = save_drone[i];
+            }
+            else if (save_drone[i] >= maxDrone[1]) {
+                maxDrone[2] = maxDrone[1];
+                maxDrone[1] = save_drone[i];
+            }
+            else if (save_drone[i] >= maxDrone[2]) {
+                maxDrone[2] = save_drone[i];
+            }
+        }
+
+        double best_cost = 0;
+        REP(k, M) best_cost = max(best_cost, save_drone[k]);
+        int best_x = -1, best_y = -1, best_i = -1, best_j = -1;
+
+        REP(x, M) FOR(y, x+1, M-1) {
+            const vector<int> &node_x = drone.node[x], &node_y = drone.node[y];
+            REP(i, node_x.size()) REP(j, node_y.size()) {
+                double nDrone1_cost = save_drone[x] - instance.drone_cost[ node_x[i] ] + instance.drone_cost[ node_y[j] ];
+                double nDrone2_cost = save_drone[y] - instance.drone_cost[ node_y[j] ] + instance.drone_cost[ node_x[i] ];
+
+                double newMaxDrone[5] = { maxDrone[0], maxDrone[1], maxDrone[2], nDrone1_cost, nDrone2_cost };
+                FOR(id, 0, 2) if (newMaxDrone[id] > 1e-9 && newMaxDrone[id] <= save_drone[x]) { newMaxDrone[id] = -1; break; }
+                if (save_drone[x] != save_drone[y])
+                    FOR(id, 0, 2) if (newMaxDrone[id] > 1e-9 && newMaxDrone[id] <= save_drone[y]) { newMaxDrone[id] = -1; break; }
+
+                double nDrone_cost = -2;
+                FOR(id, 0, 4) if (nDrone_cost + 1e-9 < newMaxDrone[id]) nDrone_cost = newMaxDrone[id];
+
+                if (best_cost > nDrone_cost + 1e-9) {
+                    best_cost = nDrone_cost;
+                    best_x = x; best_y = y; best_i = i; best_j = j;
+                }
+            }
+        }
+
+        if (best_x < 0) return false;
+        swap(drone.node[best_x][best_i], drone.node[best_y][best_j]);
+        return true;
+    }
+
+    /// with one drone the guard reads node[0]: the generic code read node[1] out of bounds and ran
+    /// or skipped the swaps depending on the heap behind the single drone list
+    template<int M>
+    bool optimize_fixed(tigersugar::Instance &instance, tigersugar::Tour &vehicle, tigersugar::Drone_Tour &drone) {
+        if ( vehicle.points.empty() || drone.node[M > 1 ? 1 : 0].empty() ) return false;
+
+        double save_drone[M];
+        drone_loads<M>(instance, drone, save_drone);
+        double maxDrone0 = -1, maxDrone1 = -1;
+        REP(i, M) {
+            if (maxDrone0 + 1e-9 < save_drone[i]) {
+                maxDrone1 = maxDrone0;
+                maxDrone0 = save_drone[i];
+            }
+            else if (maxDrone1 + 1e-9 < save_drone[i]) maxDrone1 = save_drone[i];
+        }
+
+        double vehicle_cost = vehicle.distance(instance), drone_cost = 0;
+        REP(k, M) drone_cost = max(drone_cost, save_drone[k]);
+        double bestCost = max(vehicle_cost, drone_cost);
+        int best_x = -1, best_y = -1, best_i = -1;
+
+        const vector<int> &points = vehicle.points;
+        FOR(x, 0, (int) points.size()-1) {
+            int u = points[x];
+            if (u == 0) continue;
+            if ( instance.drone_cost[u] == 0 ) continue;
+
+            double base = vehicle_cost;
+            base -= instance.distance[ points[x-1] ][u];
+            base -= instance.distance[ points[x+1] ][u];
+
+            REP(y, M) {
+                const vector<int> &node = drone.node[y];
+                REP(i, node.size()) {
+                    int v = node[i];
+                    double nVehicle_cost = base;
+                    nVehicle_cost += instance.distance[ points[x-1] ][v];
+                    nVehicle_cost += instance.distance[ points[x+1] ][v];
+
+                    double nDrone_cost = save_drone[y] - instance.drone_cost[v] + instance.drone_cost[u];
+                    if (M > 1 && nDrone_cost + 1e-9 < maxDrone0) {
+                        if (save_drone[y] + 1e-9 >= maxDrone0) nDrone_cost = max( maxDrone1, nDrone_cost ); /// y la maxDrone0
+                        else nDrone_cost = maxDrone0;
+                    }
+
+                    double nCost = max( nVehicle_cost, nDrone_cost );
+                    if (bestCost > nCost + 1e-9) {
+                        bestCost = nCost;
+                        best_x = x; best_y = y; best_i = i;
+                    }
+                }
+            }
+        }
+
+        if (best_x < 0) return false;
+        swap( vehicle.points[best_x], drone.node[best_y][best_i] );
+        return true;
+    }
+
+    /// drone loads of the generic searches, per thread and reused across calls
+    thread_local vector<double> generic_loads;
+
+    bool optimize_drone_generic(tigersugar::Instance &instance, tigersugar::Drone_Tour &drone) {
         if ( (int) drone.node.size() <= 1 ) return false;
 
-        vector<double> save_drone;
-        save_drone.resize( drone.node.size() );
+        vector<double> &save_drone = generic_loads;
+        save_drone.assign( drone.node.size(), 0 );
         
         double maxDrone[3] = { -1, -1, -1 };
         FOR(i, 0, drone.node.size()-1) {
@@ -139,8 +274,8 @@ namespace local_search {
             }
         }
 
-        bool flag_optimize = false;
-        tigersugar::Drone_Tour best_drone = drone;
+        /// the best swap is recorded and applied once, the tours are not copied
+        int best_x = -1, best_y = -1, best_i = -1, best_j = -1;
         double best_cost = drone.distance(instance);
 
         FOR(x, 0, (int) drone.node.size()-1) FOR(y, x+1, (int) drone.node.size()-1) 
@@ -163,28 +298,26 @@ namespace local_search {
 
                 if (best_cost > nDrone_cost + 1e-9) {
                     best_cost = nDrone_cost;
-                    best_drone = drone;
-                    swap(best_drone.node[x][i], best_drone.node[y][j]);
-                    flag_optimize = true;
+                    best_x = x; best_y = y; best_i = i; best_j = j;
                 }
             }
 
-        drone = best_drone;
-        return flag_optimize;
+        if (best_x < 0) return false;
+        swap( drone.node[best_x][best_i], drone.node[best_y][best_j] );
+        return true;
     }
 
-    bool optimize(tigersugar::Instance &instance, tigersugar::Tour &vehicle, tigersugar::Drone_Tour &drone) {
-        if ( vehicle.points.empty() || drone.node.empty() || drone.node[1].empty() ) return false;  
+    bool optimize_generic(tigersugar::Instance &instance, tigersugar::Tour &vehicle, tigersugar::Drone_Tour &drone) {
+        if ( vehicle.points.empty() || drone.node.size() < 2 || drone.node[1].empty() ) return false;
 
-        bool flag_optimize = false;
-        tigersugar::Tour bestVehicle = vehicle;
-        tigersugar::Drone_Tour bestDrone = drone;
+        /// the best swap is recorded and applied once, the tours are not copied
+        int best_x = -1, best_y = -1, best_i = -1;
         double vehicle_cost = vehicle.distance(instance);
         double drone_cost = drone.distance(instance);
         double bestCost = max( vehicle.distance(instance), drone.distance(instance) );
 
-        vector<double> save_drone;
-        save_drone.resize( drone.node.size() );
+        vector<double> &save_drone = generic_loads;
+        save_drone.assign( drone.node.size(), 0 );
         double maxDrone0 = -1, maxDrone1 = -1;
         FOR(i, 0, drone.node.size()-1) {
             for (int x : drone.node[i]) save_drone[i] += instance.drone_cost[x];
@@ -232,10 +365,8 @@ namespace local_search {
 
             if (bestCost > nCost + 1e-9) {
                     // cerr << "LOCAL SEARCH: " << nCost << '\n';
-                flag_optimize = true;
                 bestCost = nCost;
-                bestVehicle = vehicle;
-                bestDrone = drone;
+                best_x = x; best_y = y; best_i = i;
 
                 // cerr << "??? " << bestVehicle.distance(instance) << " " << bestDrone.distance(instance) << " " << bestCost << '\n';
                 // cerr << "@@@ " << nVehicle_cost << " " << nDrone_cost << '\n';
@@ -246,8 +377,396 @@ namespace local_search {
             swap( vehicle.points[x], drone.node[y][i] );
         }
 
-        vehicle = bestVehicle;
-        drone = bestDrone;
-        return flag_optimize;
+        if (best_x < 0) return false;
+        swap( vehicle.points[best_x], drone.node[best_y][best_i] );
+        return true;
+    }
+
+    bool optimize_drone(tigersugar::Instance &instance, tigersugar::Drone_Tour &drone) {
+        switch (drone.node.size()) {
+            case 0: case 1: return false;
+            case 2: return optimize_drone_fixed<2>(instance, drone);
+            case 3: return optimize_drone_fixed<3>(instance, drone);
+            case 4: return optimize_drone_fixed<4>(instance, drone);
+            case 5: return optimize_drone_fixed<5>(instance, drone);
+            default: return optimize_drone_generic(instance, drone);
+        }
+    }
+
+    bool optimize(tigersugar::Instance &instance, tigersugar::Tour &vehicle, tigersugar::Drone_Tour &drone) {
+        switch (drone.node.size()) {
+            case 0: return false;
+            case 1: return optimize_fixed<1>(instance, vehicle, drone);
+            case 2: return optimize_fixed<2>(instance, vehicle, drone);
+            case 3: return optimize_fixed<3>(instance, vehicle, drone);
+            case 4: return optimize_fixed<4>(instance, vehicle, drone);
+            case 5: return optimize_fixed<5>(instance, vehicle, drone);
+            default: return optimize_generic(instance, vehicle, drone);
+        }
+    }
+
+    /*
+     * Relocate moves between the vehicle and the drones, without a customer coming back:
+     *  - a vehicle customer leaves the tour, saving d(p, u) + d(u, n) - d(p, n), for the least loaded drone,
+     *  - a drone customer goes to its cheapest vehicle slot among the edges at its RELOCATE_NEIGHBOURS
+     *    nearest nodes that are on the vehicle tour, O(k) per customer.
+     * The best move that lowers the makespan is applied.
+     */
+    const int RELOCATE_NEIGHBOURS = 10;
+
+    struct Relocate_Scratch {
+        vector<int> pos;     /// position of each customer on the vehicle tour, -1 if not on it
+        vector<double> load;
+    };
+
+    thread_local Relocate_Scratch relocate_scratch;
+
+    /// cheapest insertion of c between two consecutive nodes of points, next to one of its neighbours
+    double cheapest_insertion(const tigersugar::Instance &instance, const vector<int> &points, const vector<int> &pos,
+                              int c, int &slot) {
+        int last = (int) points.size() - 1;
+        double best = tigersugar::INF_DISTANCE;
+        slot = -1;
+        const vector<int> &near = instance.neighbours[c];
+        REP(k, min((int) near.size(), RELOCATE_NEIGHBOURS)) {
+            int w = near[k];
+            int p[2] = { w == 0 ? 0 : pos[w], w == 0 ? last : -1 };
+            REP(t, 2) {
+                if (p[t] < 0) continue;
+                if (p[t] > 0) { /// before w
+                    double delta = instance.distance[ points[p[t]-1] ][c] + instance.distance[c][w] - instance.distance[ points[p[t]-1] ][w];
+                    if (delta < best) { best = delta; slot = p[t]; }
+                }
+                if (p[t] < last) { /// after w
+                    double delta = instance.distance[w][c] + instance.distance[c][ points[p[t]+1] ] - instance.distance[w][ points[p[t]+1] ];
+                    if (delta < best) { best = delta; slot = p[t]+1; }
+                }
+            }
+        }
+        return best;
+    }
+
+    bool relocate(tigersugar::Instance &instance, tigersugar::Tour &vehicle, tigersugar::Drone_Tour &drone) {
+        int numDrone = instance.numDrone;
+        if ( (int) vehicle.points.size() < 2 || numDrone <= 0 ) return false;
+        const vector<int> &points = vehicle.points;
+        int last = (int) points.size() - 1;
+
+        /// drone loads, missing drones are empty
+        vector<double> &load = relocate_scratch.load;
+        load.assign(max(numDrone, drone.size()), 0);
+        REP(y, drone.size()) for (int x : drone.node[y]) load[y] += instance.drone_cost[x];
+        int max_id = 0, min_id = 0;
+        REP(y, load.size()) if (load[y] > load[max_id]) max_id = y;
+        REP(y, numDrone) if (load[y] < load[min_id]) min_id = y;
+        double second = 0;
+        REP(y, load.size()) if (y != max_id) second = max(second, load[y]);
+
+        vector<int> &pos = relocate_scratch.pos;
+        pos.assign(instance.numPoint + 1, -1);
+        FOR(p, 1, last-1) pos[ points[p] ] = p;
+
+        double vehicle_cost = vehicle.distance(instance), drone_cost = load[max_id];
+        double best = max(vehicle_cost, drone_cost);
+        int best_x = -1, best_y = -1, best_i = -1, best_slot = -1;
+
+        /// vehicle -> drone
+        FOR(x, 1, last-1) {
+            int u = points[x];
+            if (u == 0 || instance.drone_cost[u] == 0) continue;
+            double nVehicle_cost = vehicle_cost - instance.distance[ points[x-1] ][u] - instance.distance[u][ points[x+1] ]
+                                 + instance.distance[ points[x-1] ][ points[x+1] ];
+            double nCost = max( nVehicle_cost, max(drone_cost, load[min_id] + instance.drone_cost[u]) );
+            if (best > nCost + 1e-9) {
+                best = nCost;
+                best_x = x;
+            }
+        }
+
+        /// drone -> vehicle
+        REP(y, drone.size()) REP(i, drone.node[y].size()) {
+            int c = drone.node[y][i];
+            double nDrone_cost = (y == max_id) ? max(second, load[y] - instance.drone_cost[c]) : drone_cost;
+            if (nDrone_cost + 1e-9 >= best) continue;
+
+            int slot;
+            double delta = cheapest_insertion(instance, points, pos, c, slot);
+            if (slot < 0) continue;
+            double nCost = max(vehicle_cost + delta, nDrone_cost);
+            if (best > nCost + 1e-9) {
+                best = nCost;
+                best_x = -1; best_y = y; best_i = i; best_slot = slot;
+            }
+        }
+
+        if (best_x >= 0) {
+            while ( min_id >= drone.size() ) drone.add_drone();
+            drone.node[min_id].push_back( points[best_x] );
+            vehicle.points.erase( vehicle.points.begin() + best_x );
+            return true;
+        }
+        if (best_y >= 0) {
+            vehicle.points.insert( vehicle.points.begin() + best_slot, drone.node[best_y][best_i] );
+            drone.node[best_y].erase( drone.node[best_y].begin() + best_i );
+            return true;
+        }
+        return false;
     }
-}
\ No newline at end of file
+
+    /// one round of the full scans, true if any of them moved
+    bool full_pass(tigersugar::Instance &instance, tigersugar::Tour &vehicle, tigersugar::Drone_Tour &drone) {
+        bool ok = false;
+        while ( optimize_drone(instance, drone) ) { ok = true; }
+        while ( optimize(instance, vehicle, drone) ) { ok = true; }
+        while ( relocate(instance, vehicle, drone) ) { ok = true; }
+        return ok;
+    }
+
+    /*
+     * Local search driven by a queue of dirty customers (don't-look bits). A customer taken from
+     * the queue is tried with every move it is part of: vehicle <-> drone swap, drone <-> drone
+     * swap and relocate, and the best one that lowers the makespan is applied. The customers whose
+     * moves changed are queued again: the moved ones, their vehicle neighbours and the customers
+     * of the drones whose load changed. A new makespan can also unlock moves elsewhere, so an
+     * empty queue is confirmed by full_pass, and everything is queued again if it moved.
+     *
+     * Granular mode (k > 0): a vehicle customer between p and n is only swapped with the drone
+     * customers among the k nearest nodes of p or n, a drone customer c only with the vehicle
+     * customers next to one of the k nearest nodes of c. The empty queue is then confirmed by
+     * queueing everything again until a round makes no move, not by the full scans.
+     */
+    class Descent {
+    public:
+        void run(tigersugar::Instance &instance, tigersugar::Tour &vehicle, tigersugar::Drone_Tour &drone, int granular) {
+            if ( (int) vehicle.points.size() < 2 || instance.numDrone <= 0 ) {
+                while ( full_pass(instance, vehicle, drone) );
+                return;
+            }
+            this->instance = &instance;
+            this->vehicle = &vehicle;
+            this->drone = &drone;
+            this->granular = granular;
+
+            bool moved;
+            do {
+                reset();
+                moved = false;
+                while (head < (int) queue.size()) {
+                    int c = queue[head++];
+                    queued[c] = false;
+                    if (improve(c)) moved = true;
+                }
+            } while (granular > 0 ? moved : full_pass(instance, vehicle, drone));
+        }
+
+    private:
+        tigersugar::Instance *instance;
+        tigersugar::Tour *vehicle;
+        tigersugar::Drone_Tour *drone;
+        vector<int> pos, owner; /// vehicle position and drone of each customer, -1 if not there
+        vector<double> load;
+        double vehicle_cost;
+        vector<int> queue;
+        vector<bool> queued;
+        int head;
+        int granular; /// k of the granular filter, 0: every swap
+
+        void push(int c) {
+            if (c == 0 || queued[c]) return;
+            queued[c] = true;
+            queue.push_back(c);
+        }
+
+        void push_drone(int y) {
+            for (int x : drone->node[y]) push(x);
+        }
+
+        void reset() {
+            int n = instance->numPoint;
+            const vector<int> &points = vehicle->points;
+            pos.assign(n + 1, -1);
+            owner.assign(n + 1, -1);
+            FOR(p, 1, (int) points.size()-2) pos[ points[p] ] = p;
+            load.assign(max(instance->numDrone, drone->size()), 0);
+            REP(y, drone->size()) for (int x : drone->node[y]) {
+                owner[x] = y;
+                load[y] += instance->drone_cost[x];
+            }
+            vehicle_cost = vehicle->distance(*instance);
+
+            queue.clear();
+            head = 0;
+            queued.assign(n + 1, false);
+            FOR(c, 1, n) push(c);
+        }
+
+        /// largest load but the ones of drones a and b
+        double max_load(int a, int b = -1) const {
+            double res = 0;
+            REP(y, load.size()) if (y != a && y != b) res = max(res, load[y]);
+            return res;
+        }
+
+        void positions_from(int from) {
+            const vector<int> &points = vehicle->points;
+            FOR(p, max(from, 1), (int) points.size()-2) pos[ points[p] ] = p;
+        }
+
+        /// drone customer c of drone y <-> vehicle position x
+        void try_vehicle_swap(int c, int y, double rest, int x, double &best, int &type, int &best_a, int &best_b, double &best_vehicle) {
+            const tigersugar::Instance &ins = *instance;
+            const vector<int> &points = vehicle->points;
+            int u = points[x];
+            if (ins.drone_cost[u] == 0) return;
+            double nVehicle_cost = vehicle_cost - ins.distance[ points[x-1] ][u] - ins.distance[u][ points[x+1] ]
+                                 + ins.distance[ points[x-1] ][c] + ins.distance[c][ points[x+1] ];
+            double nCost = max(nVehicle_cost, max(rest, load[y] - ins.drone_cost[c] + ins.drone_cost[u]));
+            if (best > nCost + 1e-9) { best = nCost; type = 0; best_a = x; best_b = c; best_vehicle = nVehicle_cost; }
+        }
+
+        /// best move of customer c, applied if it lowers the makespan
+        bool improve(int c) {
+            const tigersugar::Instance &ins = *instance;
+            vector<int> &points = vehicle->points;
+            int last = (int) points.size() - 1;
+            double best = max(vehicle_cost, max_load(-1));
+            double current = best;
+            int type = -1, best_a = -1, best_b = -1, best_c = -1;
+            double best_vehicle = 0;
+
+            if (pos[c] >= 0) {
+                int x = pos[c], p = points[x-1], n = points[x+1];
+                if (ins.drone_cost[c] == 0) return false;
+                double base = vehicle_cost - ins.distance[p][c] - ins.distance[c][n];
+
+                /// vehicle <-> drone swap, with a granular filter only the drone customers near p or n
+                if (granular > 0) {
+                    int ends[2] = { p, n };
+                    REP(t, 2) {
+                        const vector<int> &near = ins.neighbours[ ends[t] ];
+                        REP(k, min((int) near.size(), granular)) {
+                            int v = near[k];
+                            if (owner[v] < 0) continue;
+                            double nVehicle_cost = base + ins.distance[p][v] + ins.distance[v][n];
+                            double nCost = max(nVehicle_cost, max(max_load(owner[v]), load[ owner[v] ] - ins.drone_cost[v] + ins.drone_cost[c]));
+                            if (best > nCost + 1e-9) { best = nCost; type = 0; best_a = x; best_b = v; best_vehicle = nVehicle_cost; }
+                        }
+                    }
+                }
+                else REP(y, drone->size()) {
+                    double rest = max_load(y);
+                    for (int v : drone->node[y]) {
+                        double nVehicle_cost = base + ins.distance[p][v] + ins.distance[v][n];
+                        double nCost = max(nVehicle_cost, max(rest, load[y] - ins.drone_cost[v] + ins.drone_cost[c]));
+                        if (best > nCost + 1e-9) { best = nCost; type = 0; best_a = x; best_b = v; best_vehicle = nVehicle_cost; }
+                    }
+                }
+
+                /// relocate to the least loaded drone
+                int min_id = 0;
+                REP(y, instance->numDrone) if (load[y] < load[min_id]) min_id = y;
+                double nVehicle_cost = base + ins.distance[p][n];
+                double nCost = max(nVehicle_cost, max(max_load(min_id), load[min_id] + ins.drone_cost[c]));
+                if (best > nCost + 1e-9) { best = nCost; type = 1; best_a = min_id; best_vehicle = nVehicle_cost; }
+            }
+            else if (owner[c] >= 0) {
+                int y = owner[c];
+                const vector<int> &node_y = drone->node[y];
+                int i = find(node_y.begin(), node_y.end(), c) - node_y.begin();
+                double rest = max_load(y);
+
+                /// drone <-> vehicle swap, with a granular filter only the positions next to a neighbour of c
+                if (granular > 0) {
+                    const vector<int> &near = ins.neighbours[c];
+                    REP(k, min((int) near.size(), granular)) {
+                        int w = near[k];
+                        int q[2] = { w == 0 ? 0 : pos[w], w == 0 ? last : -1 };
+                        REP(t, 2) if (q[t] >= 0) {
+                            if (q[t] > 1) try_vehicle_swap(c, y, rest, q[t]-1, best, type, best_a, best_b, best_vehicle);
+                            if (q[t] < last-1) try_vehicle_swap(c, y, rest, q[t]+1, best, type, best_a, best_b, best_vehicle);
+                        }
+                    }
+                }
+                else FOR(x, 1, last-1) try_vehicle_swap(c, y, rest, x, best, type, best_a, best_b, best_vehicle);
+
+                /// drone <-> drone swap
+                REP(z, drone->size()) if (z != y) {
+                    double others = max(vehicle_cost, max_load(y, z));
+                    const vector<int> &node_z = drone->node[z];
+                    REP(j, node_z.size()) {
+                        int w = node_z[j];
+                        double nLoad_y = load[y] - ins.drone_cost[c] + ins.drone_cost[w];
+                        double nLoad_z = load[z] - ins.drone_cost[w] + ins.drone_cost[c];
+                        double nCost = max(others, max(nLoad_y, nLoad_z));
+                        if (best > nCost + 1e-9) { best = nCost; type = 2; best_a = z; best_b = j; best_c = i; }
+                    }
+                }
+
+                /// relocate to the vehicle
+                int slot;
+                double delta = cheapest_insertion(ins, points, pos, c, slot);
+                if (slot >= 0) {
+                    double nCost = max(vehicle_cost + delta, max(rest, load[y] - ins.drone_cost[c]));
+                    if (best > nCost + 1e-9) { best = nCost; type = 3; best_a = y; best_b = i; best_c = slot; best_vehicle = vehicle_cost + delta; }
+                }
+            }
+            if (type < 0 || best + 1e-9 >= current) return false;
+
+            if (type == 0) { /// vehicle position best_a <-> drone customer best_b
+                int x = best_a, y = owner[best_b];
+                vector<int> &node = drone->node[y];
+                int &u = points[x], &v = *find(node.begin(), node.end(), best_b);
+                load[y] += ins.drone_cost[u] - ins.drone_cost[v];
+                swap(u, v);
+                pos[u] = x; owner[u] = -1;
+                pos[v] = -1; owner[v] = y;
+                vehicle_cost = best_vehicle;
+                push(u); push(points[x-1]); push(points[x+1]);
+                push_drone(y);
+            }
+            else if (type == 1) { /// vehicle -> drone best_a
+                int x = pos[c], y = best_a;
+                push(points[x-1]); push(points[x+1]);
+                while ( y >= drone->size() ) drone->add_drone();
+                drone->node[y].push_back(c);
+                points.erase(points.begin() + x);
+                load[y] += ins.drone_cost[c];
+                pos[c] = -1; owner[c] = y;
+                positions_from(x);
+                vehicle_cost = best_vehicle;
+                push_drone(y);
+            }
+            else if (type == 2) { /// drone owner[c] at best_c <-> drone best_a at best_b
+                int y = owner[c], z = best_a;
+                int &w = drone->node[z][best_b];
+                load[y] += ins.drone_cost[w] - ins.drone_cost[c];
+                load[z] += ins.drone_cost[c] - ins.drone_cost[w];
+                owner[w] = y; owner[c] = z;
+                swap(drone->node[y][best_c], w);
+                push_drone(y); push_drone(z);
+            }
+            else { /// drone best_a -> vehicle slot best_c
+                int y = best_a, slot = best_c;
+                drone->node[y].erase(drone->node[y].begin() + best_b);
+                points.insert(points.begin() + slot, c);
+                load[y] -= ins.drone_cost[c];
+                owner[c] = -1;
+                positions_from(slot);
+                vehicle_cost = best_vehicle;
+                push(c); push(points[slot-1]); push(points[slot+1]);
+                push_drone(y);
+            }
+            return true;
+        }
+    };
+
+    thread_local Descent descent;
+
+    /// local optimum of the swap and relocate moves, granular > 0 limits the vehicle <-> drone swaps to
+    /// the granular nearest neighbours
+    void descend(tigersugar::Instance &instance, tigersugar::Tour &vehicle, tigersugar::Drone_Tour &drone, int granular = 0) {
+        descent.run(instance, vehicle, drone, granular);
+    }
+}
+
+#endif
@@ -0,0 +1,152 @@
+#ifndef PDSTSP_LOGGER
+#define PDSTSP_LOGGER
+
+#include "template.cpp"
+
+/*
+ * Leveled asynchronous logger.
+ * Records are pushed into a bounded lock-free ring buffer (multi-producer, single-consumer)
+ * and written to stderr by a background thread. A full buffer drops the record instead of
+ * blocking the solver thread.
+ */
+
+#ifndef LOG_COMPILE_LEVEL
+#define LOG_COMPILE_LEVEL   Logger::LEVEL_TRACE
+#endif
+
+#define LOG(lvl, message) \
+    do { \
+        if ((lvl) <= LOG_COMPILE_LEVEL && (lvl) <= Logger::max_level) { \
+            ostringstream _log_stream; \
+            _log_stream << message; \
+            Logger::push((lvl), _log_stream.str()); \
+        } \
+    } while (0)
+
+#define LOG_ERROR(message)  LOG(Logger::LEVEL_ERROR, message)
+#define LOG_INFO(message)   LOG(Logger::LEVEL_INFO, message)
+#define LOG_DEBUG(message)  LOG(Logger::LEVEL_DEBUG, message)
+#define LOG_TRACE(message)  LOG(Logger::LEVEL_TRACE, message)
+
+namespace Logger
+{
+    enum Level { LEVEL_ERROR = 0, LEVEL_INFO, LEVEL_DEBUG, LEVEL_TRACE };
+
+    const size_t CAPACITY = 1 << 12; // must be a power of two
+    const size_t MESSAGE_SIZE = 240;
+
+    struct Slot {
+        atomic<size_t> sequence;
+        int level;
+        int length;
+        char text[MESSAGE_SIZE];
+    };
+
+    int max_level = LEVEL_INFO;
+
+    Slot *ring = NULL;
+    atomic<size_t> tail(0); // next slot to be claimed by a producer
+    size_t head = 0;        // next slot to be read by the consumer
+    atomic<size_t> dropped(0);
+    atomic<bool> running(false);
+    thread worker;
+
+    const char* level_name(int level) {
+        switch (level) {
+            case LEVEL_ERROR: return "ERROR";
+            case LEVEL_INFO: return "INFO";
+            case LEVEL_DEBUG: return "DEBUG";
+            default: return "TRACE";
+        }
+    }
+
+    bool parse_level(const string &name, int &level) {
+        if (name == "error") level = LEVEL_ERROR;
+        else if (name == "info") level = LEVEL_INFO;
+        else if (name == "debug") level = LEVEL_DEBUG;
+        else if (name == "trace") level = LEVEL_TRACE;
+        else return false;
+        return true;
+    }
+
+    void write(int level, const char *text, int length) {
+        fprintf(stderr, "[%s] %.*s\n", level_name(level), length, text);
+    }
+
+    void push(int level, const string &message) {
+        int length = (int) min(message.size(), MESSAGE_SIZE);
+
+        if (!running.load(memory_order_acquire)) {
+            write(level, message.data(), length);
+            return;
+        }
+
+        size_t pos = tail.load(memory_order_relaxed);
+        Slot *slot;
+        while (true) {
+            slot = &ring[pos & (CAPACITY - 1)];
+            size_t seq = slot->sequence.load(memory_order_acquire);
+            long long diff = (long long) seq - (long long) pos;
+            if (diff == 0) {
+                if (tail.compare_exchange_weak(pos, pos + 1, memory_order_relaxed)) break;
+            }
+            else if (diff < 0) {
+                dropped.fetch_add(1, memory_order_relaxed);
+                return;
+            }
+            else pos = tail.load(memory_order_relaxed);
+        }
+
+        slot->level = level;
+        slot->length = length;
+        memcpy(slot->text, message.data(), length);
+        slot->sequence.store(pos + 1, memory_order_release);
+    }
+
+    bool drain() {
+        bool found = false;
+        while (true) {
+            Slot *slot = &ring[head & (CAPACITY - 1)];
+            if (slot->sequence.load(memory_order_acquire) != head + 1) break;
+            write(slot->level, slot->text, slot->length);
+            slot->sequence.store(head + CAPACITY, memory_order_release);
+            ++head;
+            found = true;
+        }
+        return found;
+    }
+
+    void consume() {
+        while (running.load(memory_order_acquire)) {
+            if (!drain()) {
+                fflush(stderr);
+                this_thread::sleep_for(chrono::milliseconds(2));
+            }
+        }
+        drain();
+        size_t lost = dropped.exchange(0);
+        if (lost > 0) fprintf(stderr, "[%s] %d log records dropped\n", level_name(LEVEL_ERROR), (int) lost);
+        fflush(stderr);
+    }
+
+    void stop() {
+        if (!running.exchange(false)) return;
+        worker.join();
+    }
+
+    void start(int level) {
+        max_level = level;
+        if (running.load()) return;
+
+        if (ring == NULL) {
+            ring = new Slot[CAPACITY];
+            for (size_t i = 0; i < CAPACITY; ++i) ring[i].sequence.store(i, memory_order_relaxed);
+            atexit(stop);
+        }
+
+        running.store(true, memory_order_release);
+        worker = thread(consume);
+    }
+}
+
+#endif
@@ -0,0 +1,127 @@
+#ifndef PDSTSP_LOWER_BOUND
+#define PDSTSP_LOWER_BOUND
+
+#include "paper/utilities.cpp"
+
+/*
+ * Lower bound of the makespan. For a makespan C:
+ *  - a customer with 2 d(0, x) > C can only be served by a drone,
+ *  - a customer with drone cost > C (or not eligible) can only be served by the vehicle,
+ * so C is only reachable if no customer is in both sets, the forced drone load fits in
+ * numDrone * C and the Held-Karp bound of the forced vehicle set is at most C.
+ * Every C at or above the optimum passes these tests, the bound is the smallest C found to pass.
+ */
+namespace Lower_Bound
+{
+    const int HK_ITERATIONS = 50;
+
+    double cost(const tigersugar::Instance &instance, int u, int v) {
+        return min(instance.distance[u][v], instance.distance[v][u]);
+    }
+
+    /// Held-Karp (1-tree with subgradient optimization) bound of a tour through nodes, nodes[0] is the depot
+    double held_karp(const tigersugar::Instance &instance, const vector<int> &nodes, int iterations = HK_ITERATIONS) {
+        int k = nodes.size();
+        if (k <= 1) return 0;
+        if (k == 2) return 2 * cost(instance, nodes[0], nodes[1]);
+
+        /// nearest neighbour tour, upper bound for the step size
+        double upper = 0;
+        vector<bool> used(k, false);
+        int cur = 0;
+        used[0] = true;
+        REP(step, k - 1) {
+            int nxt = -1;
+            REP(j, k) if (!used[j] && (nxt < 0 || cost(instance, nodes[cur], nodes[j]) < cost(instance, nodes[cur], nodes[nxt]))) nxt = j;
+            upper += cost(instance, nodes[cur], nodes[nxt]);
+            used[nxt] = true;
+            cur = nxt;
+        }
+        upper += cost(instance, nodes[cur], nodes[0]);
+
+        vector<double> pi(k, 0), dist(k);
+        vector<int> parent(k), degree(k);
+        double best = 0, lambda = 2;
+        int idle = 0;
+        REP(it, iterations) {
+            /// minimum spanning tree of nodes[1..k-1], then the two cheapest edges of the depot
+            fill(degree.begin(), degree.end(), 0);
+            fill(used.begin(), used.end(), false);
+            FOR(j, 1, k-1) { dist[j] = 1e18; parent[j] = -1; }
+            dist[1] = 0;
+            double tree = 0;
+            REP(step, k - 1) {
+                int u = -1;
+                FOR(j, 1, k-1) if (!used[j] && (u < 0 || dist[j] < dist[u])) u = j;
+                used[u] = true;
+                tree += dist[u];
+                if (parent[u] >= 0) { ++degree[u]; ++degree[parent[u]]; }
+                FOR(j, 1, k-1) if (!used[j]) {
+                    double w = cost(instance, nodes[u], nodes[j]) + pi[u] + pi[j];
+                    if (w < dist[j]) { dist[j] = w; parent[j] = u; }
+                }
+            }
+            int a = -1, b = -1;
+            FOR(j, 1, k-1) {
+                double w = cost(instance, nodes[0], nodes[j]) + pi[j];
+                if (a < 0 || w < cost(instance, nodes[0], nodes[a]) + pi[a]) { b = a; a = j; }
+                else if (b < 0 || w < cost(instance, nodes[0], nodes[b]) + pi[b]) b = j;
+            }
+            tree += cost(instance, nodes[0], nodes[a]) + pi[a] + cost(instance, nodes[0], nodes[b]) + pi[b];
+            ++degree[a]; ++degree[b];
+            degree[0] = 2;
+
+            double sum_pi = 0;
+            REP(j, k) sum_pi += pi[j];
+            double bound = tree - 2 * sum_pi;
+            if (bound > best + 1e-9) { best = bound; idle = 0; }
+            else if (++idle >= 5) { lambda /= 2; idle = 0; }
+
+            double norm = 0;
+            REP(j, k) norm += (double) (degree[j] - 2) * (degree[j] - 2);
+            if (norm == 0 || upper - bound <= 1e-9) break; /// the 1-tree is a tour
+            double t = lambda * (upper - bound) / norm;
+            FOR(j, 1, k-1) pi[j] += t * (degree[j] - 2);
+        }
+        return best;
+    }
+
+    /// true if a makespan of C is not ruled out
+    bool reachable(const tigersugar::Instance &instance, double C) {
+        double drone_load = 0;
+        vector<int> vehicle(1, 0);
+        FOR(x, 1, instance.numPoint) {
+            bool eligible = instance.drone_cost[x] > 1e-9;
+            bool by_drone = eligible && instance.drone_cost[x] <= C;
+            bool by_vehicle = cost(instance, 0, x) * 2 <= C;
+            if (!by_drone && !by_vehicle) return false;
+            if (!by_vehicle) drone_load += instance.drone_cost[x];
+            if (!by_drone) vehicle.push_back(x);
+        }
+        if (drone_load > instance.numDrone * C + 1e-9) return false;
+        return held_karp(instance, vehicle) <= C + 1e-9;
+    }
+
+    /// lower bound of the optimal makespan
+    double makespan(const tigersugar::Instance &instance) {
+        double lo = 0;
+        FOR(x, 1, instance.numPoint) {
+            double best = cost(instance, 0, x) * 2;
+            if (instance.drone_cost[x] > 1e-9) best = min(best, instance.drone_cost[x]);
+            lo = max(lo, best);
+        }
+        if (reachable(instance, lo)) return lo;
+
+        double hi = lo;
+        do { lo = hi; hi = hi * 2 + 1e-9; } while (!reachable(instance, hi));
+        REP(it, 64) {
+            if (hi - lo <= 1e-10 * max(1.0, hi)) break;
+            double mid = (lo + hi) / 2;
+            if (reachable(instance, mid)) hi = mid;
+            else lo = mid;
+        }
+        return lo;
+    }
+}
+
+#endif
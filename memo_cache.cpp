@@ -0,0 +1,113 @@
+#ifndef PDSTSP_MEMO_CACHE
+#define PDSTSP_MEMO_CACHE
+
+#include "paper/utilities.cpp"
+#include "rng.cpp"
+
+/*
+ * Best 3-opt vehicle tour found for a vehicle customer set, keyed by the Zobrist hash of
+ * the set (Rng::zobrist). The cache is split into shards, each behind its own mutex, and is
+ * bounded by a byte budget: a full shard evicts its oldest entries first.
+ */
+namespace Memo_Cache
+{
+    const int NUM_SHARDS = 16;
+    const size_t ENTRY_OVERHEAD = 64; /// hash node, FIFO slot and vector header, roughly
+
+    struct Stats {
+        long long hits = 0, misses = 0, insertions = 0, evictions = 0;
+        size_t bytes = 0, entries = 0;
+    };
+
+    class Cache
+    {
+    public:
+        Cache(size_t max_bytes) : shard_bytes(max(max_bytes / NUM_SHARDS, (size_t) 1)) {}
+
+        /// copies the cached tour of the set into tour, returns false on a miss
+        bool find(uint64_t key, int size, tigersugar::Tour &tour) {
+            Shard &shard = shards[key % NUM_SHARDS];
+            lock_guard<mutex> guard(shard.lock);
+            unordered_map<uint64_t, Entry>::iterator it = shard.map.find(key);
+            if (it == shard.map.end() || it->second.tour.size() != size) { ++shard.misses; return false; }
+            ++shard.hits;
+            tour = it->second.tour;
+            return true;
+        }
+
+        /// keeps the shorter of the cached tour and tour
+        void insert(uint64_t key, const tigersugar::Tour &tour, double cost) {
+            Shard &shard = shards[key % NUM_SHARDS];
+            size_t bytes = ENTRY_OVERHEAD + tour.points.size() * sizeof(int);
+            if (bytes > shard_bytes) return;
+
+            lock_guard<mutex> guard(shard.lock);
+            unordered_map<uint64_t, Entry>::iterator it = shard.map.find(key);
+            if (it != shard.map.end()) {
+                if (cost + 1e-9 < it->second.cost) {
+                    it->second.tour = tour;
+                    it->second.cost = cost;
+                }
+                return;
+            }
+
+            while (shard.bytes + bytes > shard_bytes && !shard.order.empty()) {
+                unordered_map<uint64_t, Entry>::iterator old = shard.map.find(shard.order.front());
+                shard.order.pop_front();
+                if (old == shard.map.end()) continue;
+                shard.bytes -= old->second.bytes;
+                shard.map.erase(old);
+                ++shard.evictions;
+            }
+
+            Entry &entry = shard.map[key];
+            entry.tour = tour;
+            entry.cost = cost;
+            entry.bytes = bytes;
+            shard.order.push_back(key);
+            shard.bytes += bytes;
+            ++shard.insertions;
+        }
+
+        Stats stats() {
+            Stats res;
+            REP(i, NUM_SHARDS) {
+                lock_guard<mutex> guard(shards[i].lock);
+                res.hits += shards[i].hits;
+                res.misses += shards[i].misses;
+                res.insertions += shards[i].insertions;
+                res.evictions += shards[i].evictions;
+                res.bytes += shards[i].bytes;
+                res.entries += shards[i].map.size();
+            }
+            return res;
+        }
+
+    private:
+        struct Entry {
+            tigersugar::Tour tour;
+            double cost;
+            size_t bytes;
+        };
+
+        struct Shard {
+            mutex lock;
+            unordered_map<uint64_t, Entry> map;
+            deque<uint64_t> order;
+            size_t bytes = 0;
+            long long hits = 0, misses = 0, insertions = 0, evictions = 0;
+        };
+
+        size_t shard_bytes;
+        Shard shards[NUM_SHARDS];
+    };
+
+    /// hash of the vehicle customer set: every customer but the kept drone customers
+    uint64_t vehicle_set_key(uint64_t all_customers, const vector<pair<double, int> > &drone_keeping) {
+        uint64_t key = all_customers;
+        for (const pair<double, int> &x : drone_keeping) key ^= Rng::zobrist(x.second);
+        return key;
+    }
+}
+
+#endif
@@ -1,4 +1,9 @@
+#ifndef NN_TOUR_BUILDER
+#define NN_TOUR_BUILDER
+
 #include "utilities.cpp"
+#include "../rng.cpp"
+#include "../arena.cpp"
 
 /*
  * Build a giant tour with nearest-neighbor method.
@@ -9,7 +14,7 @@ namespace NNTourBuilder {
     tigersugar::Tour build(tigersugar::Instance &instance, int srcNode, int type = 0) {
         int limit_heap_size;
         if (type == 0) limit_heap_size = 3;
-        else limit_heap_size = rnd.next(1000000) % 2 + 1; 
+        else limit_heap_size = Rng::solver.next_int(2) + 1;
 
         tigersugar::Tour tour;
         vector<bool> added(instance.numPoint+1, false);
@@ -37,7 +42,7 @@ namespace NNTourBuilder {
                 }
             }
 
-            int id = rnd.next(111000) % (int) heap.size();
+            int id = Rng::solver.next_int((int) heap.size());
             FOR(Time, 1, id) heap.pop();
 
             tour.add( heap.top().second );
@@ -87,7 +92,7 @@ namespace NNTourBuilder {
                 }
             }
 
-            int id = rnd.next(111000) % (int) heap.size();
+            int id = Rng::solver.next_int((int) heap.size());
             FOR(Time, 1, id) heap.pop();
 
             tour.add( heap.top().second );
@@ -107,11 +112,15 @@ namespace NNTourBuilder {
 
     }
 
-    tigersugar::Tour ACO_Build_Sub_Tour2(tigersugar::Instance &instance, vector<pair<double, int> > &drone_keeping, int srcNode, vector<vector<double> > &tsp_phe) {
+    /// builds into tour, whose memory is reused
+    void ACO_Build_Sub_Tour2(tigersugar::Instance &instance, vector<pair<double, int> > &drone_keeping, int srcNode, vector<vector<double> > &tsp_phe,
+                             tigersugar::Tour &tour) {
         int limit_heap_size = 10;
+        Arena::Scope scope;
         
-        tigersugar::Tour tour;
-        vector<bool> added(instance.numPoint+1, false);
+        tour.points.clear();
+        tour.points.reserve(instance.numPoint - (int) drone_keeping.size() + 2);
+        Arena::Vector<bool> added(instance.numPoint+1, false);
 
         for (auto x : drone_keeping) added[x.second] = true;
 
@@ -121,9 +130,12 @@ namespace NNTourBuilder {
         int x = srcNode;
         int depotPos = 0;
 
-        for (int i = 1; i <= instance.numPoint - (int) drone_keeping.size(); ++i) {
-            priority_queue<pair<double, int> > heap;
+        /// emptied at every step, so their memory is reused
+        priority_queue<pair<double, int>, Arena::Vector<pair<double, int> > > heap;
+        Arena::Vector<pair<double, int> > candList;
+        candList.reserve(limit_heap_size);
 
+        for (int i = 1; i <= instance.numPoint - (int) drone_keeping.size(); ++i) {
             for (int y = 0; y <= instance.numPoint; ++y) {
                 if (added[y]) continue;
 
@@ -140,16 +152,16 @@ namespace NNTourBuilder {
             }
 
             double phe_total = 0;
-            vector<pair<double, int> > candList;
+            candList.clear();
             while ((int)heap.size() > 0) {                 
                 candList.push_back( heap.top() );
                 phe_total += heap.top().first;
 
                 heap.pop();
             }
-            shuffle ( candList.begin(), candList.end() );
+            Rng::shuffle( candList.begin(), candList.end() );
 
-            double phe_part = -phe_total * (rnd.next(1000000) / 1000000.0);
+            double phe_part = -phe_total * Rng::solver.next_double();
             phe_total = 0;
             
             for (int j = 0; j < candList.size(); j++) {                  
@@ -169,9 +181,6 @@ namespace NNTourBuilder {
         rotate(tour.points.begin(), tour.points.begin() + depotPos, tour.points.end());
         assert(tour.points.front() == 0);
         tour.add(0);
-
-        return tour;
-
     }
 
     tigersugar::Tour ACO_Build_Sub_Tour(tigersugar::Instance &instance, vector<pair<double, int> > &drone_keeping, int srcNode, vector<vector<double> > &tsp_phe) {
@@ -190,7 +199,7 @@ namespace NNTourBuilder {
             int nextVertice = -1, plus_nextVertice = -1;
             for (int y = 0; y <= instance.numPoint; ++y) {
                 if (added[y]) continue;
-                int take = rnd.next(10000000) % 100;
+                int take = Rng::solver.next_int(100);
                 
                 if (take <= 90) {
                     double cmp_val = tsp_phe[x][y] / (instance.distance[x][y]+1);
@@ -225,3 +234,5 @@ namespace NNTourBuilder {
         return tour;
     }
 }
+
+#endif
@@ -1,33 +1,152 @@
+#ifndef PMS_OPTIMIZER
+#define PMS_OPTIMIZER
+
 #include "utilities.cpp"
 
+/*
+ * Drone customers scheduled on numDrone identical machines to minimize the largest load.
+ *  - LPT: longest customer first, on the least loaded drone (lowest id on ties). The least
+ *    loaded drone is found by a linear scan up to SCAN_LIMIT drones, by a flat binary heap above;
+ *    1..5 drones use a specialization with the loads in a fixed array.
+ *  - MULTIFIT (improve): binary search of the capacity for first fit decreasing, kept when it
+ *    beats LPT. Within 13/11 of optimal against 4/3 for LPT.
+ * Work arrays are per thread and reused, a call only allocates when tour.node grows.
+ */
 namespace pms_optimizer {
-    void optimizeTour(const tigersugar::Instance &instance, tigersugar::Drone_Tour &tour) {
-        if (tour.node.empty()) {
-            tour.node.resize(1);
-            return;
+    const int SCAN_LIMIT = 8;
+    const int MULTIFIT_STEPS = 7;
+
+    struct Scratch {
+        vector<pair<double, int> > items; /// (-drone cost, customer), LPT order
+        vector<double> load;
+        vector<pair<double, int> > heap;  /// (load, drone), min-heap
+        vector<int> lpt, fit;             /// drone of each item
+    };
+
+    thread_local Scratch scratch;
+
+    /// LPT for a fleet size known at compile time, loads in a fixed array
+    template<int M>
+    double lpt_fixed(const vector<pair<double, int> > &items, vector<int> &bin) {
+        double load[M];
+        REP(i, M) load[i] = 0;
+        bin.resize(items.size());
+        REP(k, items.size()) {
+            int id = 0;
+            FOR(i, 1, M-1) if (load[i] < load[id]) id = i;
+            load[id] += -items[k].first;
+            bin[k] = id;
+        }
+
+        double res = 0;
+        REP(i, M) res = max(res, load[i]);
+        return res;
+    }
+
+    /// LPT schedule of items into bin, returns its makespan
+    double lpt(const vector<pair<double, int> > &items, int numDrone, vector<int> &bin) {
+        switch (numDrone) {
+            case 1: return lpt_fixed<1>(items, bin);
+            case 2: return lpt_fixed<2>(items, bin);
+            case 3: return lpt_fixed<3>(items, bin);
+            case 4: return lpt_fixed<4>(items, bin);
+            case 5: return lpt_fixed<5>(items, bin);
         }
 
-        vector<pair<double, int> > ls;
-        for (int x : tour.node[0]) ls.push_back( make_pair(-instance.drone_cost[x], x) );
-        sort(ls.begin(), ls.end());
+        vector<double> &load = scratch.load;
+        load.assign(numDrone, 0);
+        bin.resize(items.size());
 
-        multiset<pair<double, int> > Set;
-        REP(i, instance.numDrone) {
-            if ( i < (int) tour.node.size() ) tour.node[i].clear();
-            Set.insert(make_pair(0, i)); 
+        if (numDrone <= SCAN_LIMIT) {
+            REP(k, items.size()) {
+                int id = 0;
+                FOR(i, 1, numDrone-1) if (load[i] < load[id]) id = i;
+                load[id] += -items[k].first;
+                bin[k] = id;
+            }
+        }
+        else {
+            vector<pair<double, int> > &heap = scratch.heap;
+            heap.clear();
+            REP(i, numDrone) heap.push_back(make_pair(0.0, i)); /// sorted, already a heap
+            greater<pair<double, int> > cmp;
+            REP(k, items.size()) {
+                pop_heap(heap.begin(), heap.end(), cmp);
+                pair<double, int> &top = heap.back();
+                top.first += -items[k].first;
+                load[top.second] = top.first;
+                bin[k] = top.second;
+                push_heap(heap.begin(), heap.end(), cmp);
+            }
         }
 
-        for (auto foo : ls) {
-            int x = foo.second;
+        double res = 0;
+        REP(i, numDrone) res = max(res, load[i]);
+        return res;
+    }
 
-            auto it = Set.begin();
-            int id = it -> second;
-            double nTime = it->first + instance.drone_cost[x];
-            Set.erase(it);
-            Set.insert( make_pair(nTime, id) );
+    /// first fit decreasing with capacity C, false if some item does not fit
+    bool first_fit(const vector<pair<double, int> > &items, int numDrone, double C, vector<int> &bin, double &makespan) {
+        vector<double> &load = scratch.load;
+        load.assign(numDrone, 0);
+        bin.resize(items.size());
+        makespan = 0;
+        REP(k, items.size()) {
+            double cost = -items[k].first;
+            int id = 0;
+            while (id < numDrone && load[id] + cost > C + 1e-9) ++id;
+            if (id == numDrone) return false;
+            load[id] += cost;
+            bin[k] = id;
+            makespan = max(makespan, load[id]);
+        }
+        return true;
+    }
 
+    /// MULTIFIT schedule into bin, returns its makespan or -1 if no capacity tried fits
+    double multifit(const vector<pair<double, int> > &items, int numDrone, double upper, vector<int> &bin) {
+        double sum = 0, largest = items.empty() ? 0 : -items[0].first;
+        for (const pair<double, int> &x : items) sum += -x.first;
+        double lo = max(sum / numDrone, largest), hi = min(upper, max(2 * sum / numDrone, largest));
+
+        double best = -1, makespan;
+        REP(step, MULTIFIT_STEPS) {
+            if (hi - lo <= 1e-9) break;
+            double C = (lo + hi) / 2;
+            if (first_fit(items, numDrone, C, bin, makespan)) best = hi = C;
+            else lo = C;
+        }
+        if (best < 0 || !first_fit(items, numDrone, best, bin, makespan)) return -1;
+        return makespan;
+    }
+
+    void optimizeTour(const tigersugar::Instance &instance, tigersugar::Drone_Tour &tour, bool improve = false) {
+        if (tour.node.empty()) {
+            tour.add_drone();
+            return;
+        }
+        int numDrone = instance.numDrone;
+        if (numDrone <= 0) return;
+
+        vector<pair<double, int> > &items = scratch.items;
+        items.clear();
+        for (int x : tour.node[0]) items.push_back( make_pair(-instance.drone_cost[x], x) );
+        sort(items.begin(), items.end());
+
+        vector<int> *bin = &scratch.lpt;
+        double makespan = lpt(items, numDrone, scratch.lpt);
+        if (improve && numDrone > 1 && items.size() > 1) {
+            double fit = multifit(items, numDrone, makespan, scratch.fit);
+            if (fit >= 0 && fit + 1e-9 < makespan) bin = &scratch.fit;
+        }
+
+        REP(i, min(numDrone, tour.size())) tour.node[i].clear();
+        REP(k, items.size()) {
+            int id = (*bin)[k];
             while ( id >= (int) tour.size() ) tour.add_drone();
-            tour.node[id].push_back(x);
-        }   
+            tour.node[id].push_back(items[k].second);
+        }
     }
-}
\ No newline at end of file
+}
+
+#endif
@@ -2,6 +2,9 @@
 #define TSP_OPTIMIZER
 
 #include "utilities.cpp"
+#include "../logger.cpp"
+#include "../rng.cpp"
+#include "../arena.cpp"
 
 namespace tsp_optimizer {
     struct Tour {
@@ -10,6 +13,7 @@ namespace tsp_optimizer {
         Tour(){}
 
         Tour(const vector<int> &v) {
+            nodes.reserve(v.size() + 2);
             nodes.push_back(0);
             FORE(it, v) {
                 nodes.push_back(*it);
@@ -36,19 +40,27 @@ namespace tsp_optimizer {
         }
     };
 
+    /// matrices in the thread's arena: construct it inside an Arena::Scope.
+    /// Cost is double, or an integer type holding the distances times instance.cost_scale.
+    template<class Cost = double>
     struct TspProblem {
-        vector<vector<double>> distance;
-        vector<vector<int>> nn_list;
+        typedef typename conditional<is_floating_point<Cost>::value, double, int>::type Value; /// sums and gains
+
+        Arena::Vector<Arena::Vector<Cost>> distance;
+        Arena::Vector<Arena::Vector<int>> nn_list;
 
         TspProblem(const tigersugar::Instance &instance, const Tour &tour) {
             auto n = tour.length() - 1;
-            distance.resize(n, vector<double>(n));
-            nn_list.resize(n, vector<int>(n - 1));
+            double scale = is_floating_point<Cost>::value ? 1 : instance.cost_scale;
+            distance.resize(n, Arena::Vector<Cost>(n));
+            nn_list.resize(n, Arena::Vector<int>(n - 1));
 
-            vector<pair<double, int>> tmp;
+            Arena::Vector<pair<Cost, int>> tmp;
+            tmp.reserve(n);
             for (int i = 0; i < n; ++i) {
                 for (int j = 0; j < n; ++j) {
-                    distance[i][j] = instance.distance[tour[i]][tour[j]];
+                    double d = instance.distance[tour[i]][tour[j]] * scale;
+                    distance[i][j] = (Cost) (is_floating_point<Cost>::value ? d : round(d));
                 }
 
                 for (int j = 0; j < n; ++j) {
@@ -68,12 +80,17 @@ namespace tsp_optimizer {
     static const int nn_ls = 20;
     static const double EPS = 0.0001;
 
+    /// smallest gain taken by 2-opt / 3-opt, exact on integer costs
+    template<class Value> Value min_gain() { return 0; }
+    template<> inline double min_gain<double>() { return EPS; }
+
     enum OptimizeMethod {
         twoOptsMethod,
         threeOptsMethod
     };
 
-    void two_opt_first(vector<int> &tour, const TspProblem &instance)
+    template<class Vector, class Cost>
+    void two_opt_first(Vector &tour, const TspProblem<Cost> &instance)
     /*
       FUNCTION:       2-opt a tour
       INPUT:          pointer to the tour that undergoes local optimization
@@ -96,11 +113,14 @@ namespace tsp_optimizer {
         int i, j, h, l;
         int improvement_flag, improve_node, help, n_improves = 0, n_exchanges=0;
         int h1=0, h2=0, h3=0, h4=0;
-        double radius;          /* radius of nn-search */
-        double gain = 0;
-        vector<int> random_vector;
-        vector<int> pos(n);     /* positions of cities in tour */
-        vector<int> dlb(n);     /* vector containing don't look bits */
+        typedef typename TspProblem<Cost>::Value Value;
+        const Value EPS = min_gain<Value>();
+        Value radius;          /* radius of nn-search */
+        Value gain = 0;
+        Arena::Scope scope;
+        Arena::Vector<int> random_vector;
+        Arena::Vector<int> pos(n);     /* positions of cities in tour */
+        Arena::Vector<int> dlb(n);     /* vector containing don't look bits */
 
         for ( i = 0 ; i < n ; i++ ) {
             pos[tour[i]] = i;
@@ -108,7 +128,7 @@ namespace tsp_optimizer {
         }
 
         improvement_flag = true;
-        random_vector = rnd.perm(n);
+        Rng::perm(n, random_vector);
 
         while ( improvement_flag ) {
 
@@ -227,7 +247,8 @@ namespace tsp_optimizer {
         }
     }
 
-    void three_opt_first(vector<int> &tour, const TspProblem &instance)
+    template<class Vector, class Cost>
+    void three_opt_first(Vector &tour, const TspProblem<Cost> &instance)
     /*
       FUNCTION:       3-opt the tour
       INPUT:          pointer to the tour that is to optimize
@@ -260,7 +281,9 @@ namespace tsp_optimizer {
         int   i, j, h, g, l;
         int   improvement_flag, help;
         int   h1=0, h2=0, h3=0, h4=0, h5=0, h6=0; /* memorize cities involved in a move */
-        double   diffs, diffp;
+        typedef typename TspProblem<Cost>::Value Value;
+        const Value EPS = min_gain<Value>();
+        Value   diffs, diffp;
         int   between = false;
         int   opt2_flag;  /* = true: perform 2-opt move, otherwise none or 3-opt move */
         int   move_flag;  /*
@@ -270,22 +293,23 @@ namespace tsp_optimizer {
 			      move_flag = 3 --> not_between with predecessors of c2 and c3
 			      move_flag = 4 --> cyclic move
 			   */
-        double gain, move_value, radius, add1, add2;
-        double decrease_breaks;    /* Stores decrease by breaking two edges (a,b) (c,d) */
+        Value gain, move_value, radius, add1, add2;
+        Value decrease_breaks;    /* Stores decrease by breaking two edges (a,b) (c,d) */
         int val[3];
         int n1, n2, n3;
-        vector<int> pos(n);        /* positions of cities in tour */
-        vector<int> dlb(n);        /* vector containing don't look bits */
-        vector<int> h_tour(n);     /* help vector for performing exchange move */
-        vector<int> hh_tour(n);    /* help vector for performing exchange move */
-        vector<int> random_vector;
+        Arena::Scope scope;
+        Arena::Vector<int> pos(n);        /* positions of cities in tour */
+        Arena::Vector<int> dlb(n);        /* vector containing don't look bits */
+        Arena::Vector<int> h_tour(n);     /* help vector for performing exchange move */
+        Arena::Vector<int> hh_tour(n);    /* help vector for performing exchange move */
+        Arena::Vector<int> random_vector;
 
         for ( i = 0 ; i < n ; i++ ) {
             pos[tour[i]] = i;
             dlb[i] = false;
         }
         improvement_flag = true;
-        random_vector = rnd.perm(n);
+        Rng::perm(n, random_vector);
 
         while ( improvement_flag ) {
             move_value = 0;
@@ -1259,13 +1283,17 @@ namespace tsp_optimizer {
         }
     }
 
-    Tour optimize(const tigersugar::Instance &instance, const Tour &originalTour, OptimizeMethod method) {
+    /// the optimized tour goes into result, as nodes of the instance
+    template<class Cost>
+    void optimize(const tigersugar::Instance &instance, const Tour &originalTour, OptimizeMethod method, vector<int> &result) {
 //        printf("Original: ");
 //        FORE(it, originalTour.nodes) printf("%d ", *it); printf("\n");
 
         // Map to TSP problem
-        TspProblem problem(instance, originalTour);
-        vector<int> nodes;
+        Arena::Scope scope;
+        TspProblem<Cost> problem(instance, originalTour);
+        Arena::Vector<int> nodes;
+        nodes.reserve(originalTour.length());
         for (int i = 0; i < originalTour.length(); ++i) {
             if (i + 1 < originalTour.length()) {
                 nodes.push_back(i);
@@ -1287,36 +1315,46 @@ namespace tsp_optimizer {
         nodes.push_back(0);
 
         // build new tour
-        Tour tour;
+        result.clear();
         for (int x : nodes) {
-            tour.append(originalTour[x]);
+            result.push_back(originalTour[x]);
         }
 //        printf("After: ");
-//        FORE(it, tour.nodes) printf("%d ", *it); printf("\n");
+//        FORE(it, result) printf("%d ", *it); printf("\n");
+    }
 
-        return tour;
+    /// local search on the narrowest distance type of the instance
+    void optimize(const tigersugar::Instance &instance, const Tour &originalTour, OptimizeMethod method, vector<int> &result) {
+        switch (instance.cost_type) {
+            case tigersugar::SHORT_COST: return optimize<uint16_t>(instance, originalTour, method, result);
+            case tigersugar::INT_COST: return optimize<int>(instance, originalTour, method, result);
+            default: return optimize<double>(instance, originalTour, method, result);
+        }
     }
 
+    /// input of optimizeTour, per thread and reused across calls
+    thread_local Tour original_tour;
+
     void optimizeTour(const tigersugar::Instance &instance, tigersugar::Tour &tour,
                       OptimizeMethod method = threeOptsMethod) {
         tigersugar::Distance oldDistance = tour.distance(instance);
-        vector<int> org = tour.points;
-
-        tour.points.pop_back(); 
-        tour.points.erase(tour.points.begin());
+        Arena::Scope scope;
+        Arena::Vector<int> org(tour.points.begin(), tour.points.end());
 
-        Tour tmp = optimize(instance, Tour(tour.points), method);
-        ensure(tmp.nodes.size() >= 2 && tmp.nodes.front() == 0 && tmp.nodes.back() == 0);
-        tour.points = vector<int>(tmp.nodes.begin(), tmp.nodes.end());
+        /// tour.points already has the depot at both ends, as Tour(points) would add it
+        original_tour.nodes.assign(tour.points.begin(), tour.points.end());
+        optimize(instance, original_tour, method, tour.points);
+        ensure(tour.points.size() >= 2 && tour.points.front() == 0 && tour.points.back() == 0);
         tigersugar::Distance newDistance = tour.distance(instance);
 
         if (newDistance > oldDistance + 1e-9) {
-            for (int x : org) cerr << x << " ";
-            cerr << '\n';
-            for (int x : tour.points) cerr << x << " ";
-            cerr << '\n';
+            ostringstream before, after;
+            for (int x : org) before << x << " ";
+            for (int x : tour.points) after << x << " ";
 
-            cerr << "???? " << newDistance << " " << oldDistance << '\n';
+            LOG_ERROR("3-opt made the tour longer: " << oldDistance << " -> " << newDistance);
+            LOG_ERROR("before: " << before.str());
+            LOG_ERROR("after:  " << after.str());
             exit(0);
         }
 
@@ -46,23 +46,76 @@ namespace tigersugar {
 
 typedef double Distance;
 const Distance INF_DISTANCE = (double) 1e9 + 7;
+const int NUM_NEIGHBOURS = 32;
+const int MAX_COST_SCALE = 1000;
+const int MAX_INT_COST = INT_MAX / 8; /// a 3-opt gain adds up to six matrix entries
+
+/// storage of the vehicle distances in the TSP kernels
+enum Cost_Type { REAL_COST, INT_COST, SHORT_COST };
 
 struct Instance {
     double time_limit;
+    int loop_limit;
     int numPoint, numDrone, numDroneEligible;
     vector<pair<int, double> > lsDroneEligible;
     vector<double> drone_cost; 
     vector<vector<double> > distance;
+    vector<vector<int> > neighbours; /// nearest nodes of each node by round trip distance, depot included
+    Cost_Type cost_type;
+    int cost_scale; /// distance times cost_scale is an integer unless cost_type is REAL_COST
 
     Instance(int numPoint, int numDrone, int numDroneEligible) {
         this->numPoint = numPoint;
         this->numDrone = numDrone;
         this->numDroneEligible = numDroneEligible;
+        this->time_limit = 300;
+        this->loop_limit = 10000;
+        this->cost_type = REAL_COST;
+        this->cost_scale = 1;
 
         drone_cost.resize(numPoint+1, 0);
         distance.resize(numPoint+1);
         FOR(i, 0, numPoint) distance[i].resize(numPoint+1, 0);
     }
+
+    /// k nearest nodes of every node, called once the distances are set
+    void build_neighbours(int k = NUM_NEIGHBOURS) {
+        k = min(k, numPoint);
+        neighbours.assign(numPoint+1, vector<int>());
+        vector<int> order;
+        FOR(u, 0, numPoint) {
+            order.clear();
+            FOR(v, 0, numPoint) if (v != u) order.push_back(v);
+            partial_sort(order.begin(), order.begin() + k, order.end(), [&] (int a, int b) {
+                double da = distance[u][a] + distance[a][u], db = distance[u][b] + distance[b][u];
+                return da < db || (da == db && a < b);
+            });
+            neighbours[u].assign(order.begin(), order.begin() + k);
+        }
+    }
+
+    /// smallest scale up to max_scale that makes every vehicle distance an integer, and the
+    /// narrowest integer type that holds the scaled distances; REAL_COST if there is none
+    void detect_cost_type(int max_scale = MAX_COST_SCALE) {
+        cost_type = REAL_COST;
+        cost_scale = 1;
+        double largest = 0;
+        FOR(i, 0, numPoint) FOR(j, 0, numPoint) largest = max(largest, distance[i][j]);
+
+        FOR(scale, 1, max_scale) {
+            if (largest * scale > MAX_INT_COST) return;
+            bool integral = true;
+            for (int i = 0; i <= numPoint && integral; ++i) FOR(j, 0, numPoint) {
+                double x = distance[i][j] * scale;
+                if (x < 0 || fabs(x - round(x)) > 1e-6) { integral = false; break; }
+            }
+            if (!integral) continue;
+
+            cost_scale = scale;
+            cost_type = (round(largest * scale) <= USHRT_MAX) ? SHORT_COST : INT_COST;
+            return;
+        }
+    }
 };
 
 struct Tour {
@@ -111,10 +164,16 @@ struct Tour {
     }
 };
 
+/// drone lists dropped by Drone_Tour::resize_drones, add_drone hands them out again with their memory
+thread_local vector<vector<int> > spare_drone_lists;
+
 struct Drone_Tour {
     vector<vector<int> > node;
 
-    vector<int> operator [] (int x) const {
+    vector<int>& operator [] (int x) {
+        return node[x];
+    }
+    const vector<int>& operator [] (int x) const {
         return node[x];
     }
 
@@ -127,12 +186,24 @@ struct Drone_Tour {
     }
 
     void add_drone() {
-        node.push_back(vector<int>());
+        if (spare_drone_lists.empty()) { node.push_back(vector<int>()); return; }
+        node.push_back(move(spare_drone_lists.back()));
+        spare_drone_lists.pop_back();
     }
 
-    Distance distance(const Instance &instance) {
+    /// k drones, dropped lists are emptied and kept for add_drone instead of freed
+    void resize_drones(int k) {
+        while ((int) node.size() > k) {
+            node.back().clear();
+            spare_drone_lists.push_back(move(node.back()));
+            node.pop_back();
+        }
+        while ((int) node.size() < k) add_drone();
+    }
+
+    Distance distance(const Instance &instance) const {
         Distance res = 0;
-        for (vector<int> drone : node) {
+        for (const vector<int> &drone : node) {
             Distance val = 0;
             for (int x : drone) val += instance.drone_cost[x];
             maximize(res, val);
@@ -140,9 +211,9 @@ struct Drone_Tour {
         return res;
     }
 
-    int numPointAssigned() {
+    int numPointAssigned() const {
         int res = 0;
-        for (vector<int> vec : node) res += vec.size();
+        for (const vector<int> &vec : node) res += vec.size();
         return res;
     }
 
@@ -1,14 +1,19 @@
+#ifndef PDSTSP_INPUT_ADAPTATION
+#define PDSTSP_INPUT_ADAPTATION
+
 #include "paper/utilities.cpp"
 #include "problem.cpp"
 
 namespace Input_Adaptation {
+    /// without drones no customer is drone eligible, the vehicle serves everyone
     tigersugar::Instance Process() {
         tigersugar::Instance instance(Problem::n, Problem::m, Problem::nD);
         instance.time_limit = Problem::time_limit;
+        instance.loop_limit = Problem::loop_limit;
 
         REP(i, Problem::dCost.size()) {
             instance.drone_cost[i] = Problem::dCost[i];
-            if (instance.drone_cost[i] == Constant::INF) instance.drone_cost[i] = 0;
+            if (instance.drone_cost[i] == Constant::INF || Problem::m <= 0) instance.drone_cost[i] = 0;
             else instance.lsDroneEligible.push_back( make_pair(i, instance.drone_cost[i]) );
         }
 
@@ -19,6 +24,35 @@ namespace Input_Adaptation {
             return u.second > v.second;
         });
 
+        instance.build_neighbours();
+        instance.detect_cost_type();
+        return instance;
+    }
+
+    /// same instance as Process() from coordinates, drone_eligible[0] is the flag of the depot line
+    tigersugar::Instance Build(const vector<Point::point> &points, const vector<bool> &drone_eligible,
+                               int numDrone, double vSpeed, double dSpeed) {
+        int n = (int) points.size() - 1;
+        int nD = 0;
+        if (numDrone > 0) REP(i, points.size()) if (drone_eligible[i]) ++nD;
+
+        tigersugar::Instance instance(n, numDrone, nD);
+        FOR(i, 0, n) {
+            if (drone_eligible[i] && numDrone > 0) {
+                instance.drone_cost[i] = 2 * Point::euclidean_distance(points[0], points[i]) / dSpeed;
+                instance.lsDroneEligible.push_back( make_pair(i, instance.drone_cost[i]) );
+            }
+            FOR(j, 0, n) instance.distance[i][j] = Point::manhattan_distance(points[i], points[j]) / vSpeed;
+        }
+
+        sort(instance.lsDroneEligible.begin(), instance.lsDroneEligible.end(), [] (pair<int, double> u, pair<int, double> v){
+            return u.second > v.second;
+        });
+
+        instance.build_neighbours();
+        instance.detect_cost_type();
         return instance;
     }
-}
\ No newline at end of file
+}
+
+#endif
@@ -5,6 +5,7 @@
 
 #include "point.cpp"
 #include "constant.cpp"
+#include "logger.cpp"
 
 using namespace std;
 
@@ -16,6 +17,9 @@ namespace Problem
     vector<double> dCost; // cost of traveling by a drone from depot to customer and return
     vector<vector<double> > vCost; // cost of traveling by the vehicle from this customer to another
 
+    vector<Point::point> points; // coordinates, points[0] is the depot
+    double vehicle_speed, drone_speed;
+
     int nD; // Number of drone-eligible customers
 
     double result;
@@ -27,32 +31,50 @@ namespace Problem
 
     string output;
 
+    /// read the depot and n customers of an instance file, touches no global
+    bool read_points(const string &input_file, int n, vector<Point::point> &points, vector<bool> &drone_eligible)
+    {
+        ifstream input(input_file);
+        points.clear();
+        drone_eligible.clear();
+
+        for(int i = 0; i <= n; ++i)
+        {
+            char temp;
+            int id, flag;
+            double x, y;
+            input >> id >> temp >> x >> temp >> y >> temp >> flag;
+            points.push_back(Point::point(x, y));
+            drone_eligible.push_back(flag != 1);
+        }
+        return (bool) input;
+    }
+
     void import_data_from_tsplib_instance(string input_file, int _n, int _m, double vSpeed, double dSpeed, double _time_limit, int _loop_limit, string _output)
     {
         // sV: speed of vehicle
         // sD: speed of drone
 
-        cerr << "Reading data from " << input_file << "...\n";
+        LOG_INFO("Reading data from " << input_file << "...");
 
         n = _n;
         m = _m;
+        nD = 0;
+        dCost.clear();
+        vCost.clear();
+        vehicle_speed = vSpeed;
+        drone_speed = dSpeed;
         time_limit = _time_limit;
         loop_limit = _loop_limit;
         output = _output;
         
 	    input_file = "data/" + input_file;
-        ifstream input(input_file);
-        vector<Point::point> points;
+        vector<bool> drone_eligible;
+        if (!read_points(input_file, n, points, drone_eligible)) LOG_ERROR("Can not read " << input_file);
 
         for(int i = 0; i <= n; ++i)
         {
-            char temp;
-            int id, drone_eligible;
-            double x, y;
-            input >> id >> temp >> x >> temp >> y >> temp >> drone_eligible;
-            drone_eligible = 1 - drone_eligible;
-            points.push_back(Point::point(x, y));
-            if (drone_eligible)
+            if (drone_eligible[i])
             {
                 dCost.push_back(2 * Point::euclidean_distance(points[0], points[i]) / dSpeed);
                 nD++;
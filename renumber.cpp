@@ -0,0 +1,111 @@
+#ifndef PDSTSP_RENUMBER
+#define PDSTSP_RENUMBER
+
+#include "paper/utilities.cpp"
+#include "point.cpp"
+
+/*
+ * Internal renumbering of the customers (--renumber hilbert). Customers are numbered along a
+ * Hilbert curve through their coordinates, so customers close in the plane get close ids and
+ * the rows of the n^2 structures (distance, tsp_phe, the 3-opt matrices) touched together are
+ * close in memory. The depot stays 0. The solver only sees the renumbered instance; tours are
+ * mapped to internal ids on the way in (warm start) and back to file ids before the output.
+ */
+namespace Renumber
+{
+    const int HILBERT_ORDER = 16; /// the curve walks a 2^16 x 2^16 grid
+
+    /// position of the cell (x, y) along the Hilbert curve of the 2^order grid
+    uint64_t hilbert_index(uint32_t x, uint32_t y, int order = HILBERT_ORDER) {
+        uint64_t d = 0;
+        for (uint32_t s = 1u << (order - 1); s > 0; s >>= 1) {
+            uint32_t rx = (x & s) ? 1 : 0, ry = (y & s) ? 1 : 0;
+            d += (uint64_t) s * s * ((3 * rx) ^ ry);
+            if (ry == 0) {
+                if (rx == 1) {
+                    x = s - 1 - x;
+                    y = s - 1 - y;
+                }
+                swap(x, y);
+            }
+        }
+        return d;
+    }
+
+    struct Permutation {
+        vector<int> original; /// file id of each internal id, empty for the identity
+        vector<int> internal; /// internal id of each file id
+
+        bool identity() const { return original.empty(); }
+
+        /// file ids to internal ids, in place
+        void to_internal(vector<int> &ids) const {
+            if (identity()) return;
+            for (int &x : ids) x = internal[x];
+        }
+
+        /// internal ids to file ids, in place
+        void to_original(vector<int> &ids) const {
+            if (identity()) return;
+            for (int &x : ids) x = original[x];
+        }
+
+        /// the instance with customer original[i] as customer i
+        tigersugar::Instance apply(const tigersugar::Instance &instance) const {
+            if (identity()) return instance;
+            int n = instance.numPoint;
+            tigersugar::Instance res(n, instance.numDrone, instance.numDroneEligible);
+            res.time_limit = instance.time_limit;
+            res.loop_limit = instance.loop_limit;
+
+            FOR(i, 0, n) {
+                res.drone_cost[i] = instance.drone_cost[original[i]];
+                const vector<double> &row = instance.distance[original[i]];
+                FOR(j, 0, n) res.distance[i][j] = row[original[j]];
+            }
+            for (const pair<int, double> &x : instance.lsDroneEligible)
+                res.lsDroneEligible.push_back( make_pair(internal[x.first], x.second) );
+
+            res.build_neighbours();
+            res.detect_cost_type();
+            return res;
+        }
+    };
+
+    /// customers sorted by their Hilbert index, ties by file id
+    Permutation hilbert(const vector<Point::point> &points) {
+        Permutation res;
+        int n = (int) points.size() - 1;
+        if (n < 2) return res;
+
+        double min_x = points[1].x, max_x = points[1].x, min_y = points[1].y, max_y = points[1].y;
+        FOR(i, 1, n) {
+            min_x = min(min_x, points[i].x); max_x = max(max_x, points[i].x);
+            min_y = min(min_y, points[i].y); max_y = max(max_y, points[i].y);
+        }
+        double cells = (double) ((1u << HILBERT_ORDER) - 1);
+        double scale = cells / max(max(max_x - min_x, max_y - min_y), 1e-9);
+
+        vector<pair<uint64_t, int> > order;
+        FOR(i, 1, n) {
+            uint32_t x = (uint32_t) min(cells, (points[i].x - min_x) * scale);
+            uint32_t y = (uint32_t) min(cells, (points[i].y - min_y) * scale);
+            order.push_back( make_pair(hilbert_index(x, y), i) );
+        }
+        sort(order.begin(), order.end());
+
+        res.original.push_back(0);
+        for (const pair<uint64_t, int> &x : order) res.original.push_back(x.second);
+        res.internal.assign(n + 1, 0);
+        FOR(i, 0, n) res.internal[res.original[i]] = i;
+        return res;
+    }
+
+    /// permutation for a --renumber value: none or hilbert
+    Permutation build(const string &method, const vector<Point::point> &points) {
+        if (method == "hilbert") return hilbert(points);
+        return Permutation();
+    }
+}
+
+#endif
@@ -0,0 +1,143 @@
+#ifndef PDSTSP_RNG
+#define PDSTSP_RNG
+
+#include "template.cpp"
+
+/*
+ * Random number generation of the solver: xoshiro256** seeded through splitmix64.
+ * Every thread owns its generator (Rng::solver). Independent streams are obtained by
+ * jumping ahead: long_jump() separates runs, jump() separates workers of the same run.
+ */
+namespace Rng
+{
+    struct Xoshiro256 {
+        uint64_t s[4];
+
+        Xoshiro256(uint64_t seed = 1) {
+            set_seed(seed);
+        }
+
+        static uint64_t rotl(uint64_t x, int k) {
+            return (x << k) | (x >> (64 - k));
+        }
+
+        void set_seed(uint64_t seed) {
+            for (int i = 0; i < 4; ++i) {
+                uint64_t z = (seed += 0x9e3779b97f4a7c15ULL);
+                z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+                z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+                s[i] = z ^ (z >> 31);
+            }
+        }
+
+        uint64_t next() {
+            uint64_t result = rotl(s[1] * 5, 7) * 9;
+            uint64_t t = s[1] << 17;
+            s[2] ^= s[0];
+            s[3] ^= s[1];
+            s[1] ^= s[2];
+            s[0] ^= s[3];
+            s[2] ^= t;
+            s[3] = rotl(s[3], 45);
+            return result;
+        }
+
+        /// uniform integer in [0, n)
+        int next_int(int n) {
+            return (int) (((next() >> 32) * (uint64_t) n) >> 32);
+        }
+
+        /// uniform real in [0, 1)
+        double next_double() {
+            return (next() >> 11) * (1.0 / 9007199254740992.0);
+        }
+
+        void advance(const uint64_t (&table)[4]) {
+            uint64_t t[4] = { 0, 0, 0, 0 };
+            for (int i = 0; i < 4; ++i)
+                for (int b = 0; b < 64; ++b) {
+                    if (table[i] & (1ULL << b))
+                        for (int j = 0; j < 4; ++j) t[j] ^= s[j];
+                    next();
+                }
+            for (int j = 0; j < 4; ++j) s[j] = t[j];
+        }
+
+        /// equivalent to 2^128 calls of next()
+        void jump() {
+            static const uint64_t JUMP[4] = { 0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL,
+                                              0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL };
+            advance(JUMP);
+        }
+
+        /// equivalent to 2^192 calls of next()
+        void long_jump() {
+            static const uint64_t LONG_JUMP[4] = { 0x76e15d3efefdcbbfULL, 0xc5004e441c522fb3ULL,
+                                                   0x77710069854ee241ULL, 0x39109bb02acbe635ULL };
+            advance(LONG_JUMP);
+        }
+    };
+
+    /*
+     * Bernoulli trials drawn four at a time from one 64-bit word,
+     * each with probability threshold / 65536.
+     */
+    struct Bernoulli_Batch {
+        Xoshiro256 &gen;
+        uint32_t threshold;
+        uint64_t word;
+        int left;
+
+        Bernoulli_Batch(Xoshiro256 &_gen, double probability) : gen(_gen), word(0), left(0) {
+            threshold = (uint32_t) max(0.0, min(65536.0, round(probability * 65536.0)));
+        }
+
+        bool next() {
+            if (left == 0) { word = gen.next(); left = 4; }
+            uint32_t u = (uint32_t) (word & 0xFFFF);
+            word >>= 16;
+            --left;
+            return u < threshold;
+        }
+    };
+
+    thread_local Xoshiro256 solver;
+
+    /// fixed random key of a customer for Zobrist hashing of customer sets, splitmix64 of its id
+    uint64_t zobrist(int x) {
+        uint64_t z = (uint64_t) x * 0x9e3779b97f4a7c15ULL + 0x632be59bd9b4e019ULL;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+    /// stream of worker `worker` in run `run` of a solve seeded with `seed`
+    void seed_stream(uint64_t seed, int run, int worker = 0) {
+        Xoshiro256 gen(seed);
+        for (int i = 0; i < run; ++i) gen.long_jump();
+        for (int i = 0; i < worker; ++i) gen.jump();
+        solver = gen;
+    }
+
+    template<class Iterator>
+    void shuffle(Iterator first, Iterator last) {
+        int n = (int) (last - first);
+        for (int i = n - 1; i > 0; --i) swap(first[i], first[solver.next_int(i + 1)]);
+    }
+
+    /// random permutation of 0..n-1 into p, any vector type
+    template<class Vector>
+    void perm(int n, Vector &p) {
+        p.resize(n);
+        for (int i = 0; i < n; ++i) p[i] = i;
+        shuffle(p.begin(), p.end());
+    }
+
+    vector<int> perm(int n) {
+        vector<int> p;
+        perm(n, p);
+        return p;
+    }
+}
+
+#endif
@@ -0,0 +1,104 @@
+#ifndef PDSTSP_SOLUTION_READER
+#define PDSTSP_SOLUTION_READER
+
+#include "paper/utilities.cpp"
+
+/*
+ * Read back a solution written by Problem::print_result_to_file or winter_main.
+ * A winter_main result file holds one solution per run, the one with the smallest result is kept.
+ */
+namespace Solution_Reader
+{
+    struct Solution {
+        double result = -1;
+        tigersugar::Tour vehicle;
+        tigersugar::Drone_Tour drone;
+    };
+
+    string lower(const string &s) {
+        string res = s;
+        for (char &c : res) c = tolower(c);
+        return res;
+    }
+
+    bool starts_with(const string &s, const string &prefix) {
+        return s.compare(0, prefix.size(), prefix) == 0;
+    }
+
+    vector<int> read_ids(const string &line) {
+        vector<int> ids;
+        istringstream is(line.substr(line.find(':') + 1));
+        int x;
+        while (is >> x) ids.push_back(x);
+        return ids;
+    }
+
+    /// returns false if the file has no complete solution
+    bool read(const string &solution_file, Solution &best) {
+        ifstream input(solution_file);
+        if (!input) return false;
+
+        vector<Solution> solutions;
+        string line;
+        while (getline(input, line)) {
+            string key = lower(line);
+
+            if (starts_with(key, "result:")) {
+                solutions.push_back(Solution());
+                solutions.back().result = atof(line.c_str() + line.find(':') + 1);
+            }
+            else if (solutions.empty()) continue;
+            else if (starts_with(key, "vehicle tour:")) {
+                solutions.back().vehicle.points = read_ids(line);
+            }
+            else if (starts_with(key, "customers of drone #") || (starts_with(key, "drone ") && isdigit(key[6]))) {
+                int id = atoi(key.c_str() + key.find_first_of("0123456789")) - 1;
+                if (id < 0) continue;
+                tigersugar::Drone_Tour &drone = solutions.back().drone;
+                while (drone.size() <= id) drone.add_drone();
+                drone.node[id] = read_ids(line);
+            }
+        }
+
+        bool found = false;
+        for (const Solution &sol : solutions) {
+            if (sol.vehicle.empty()) continue;
+            if (!found || sol.result < best.result) best = sol;
+            found = true;
+        }
+        return found;
+    }
+
+    /// returns an empty string if the solution is feasible for the instance, the reason otherwise
+    string validate(const tigersugar::Instance &instance, Solution &sol) {
+        const tigersugar::Tour &vehicle = sol.vehicle;
+        tigersugar::Drone_Tour &drone = sol.drone;
+        ostringstream error;
+        if (vehicle.size() < 2 || vehicle.points.front() != 0 || vehicle.points.back() != 0)
+            return "the vehicle tour must start and finish at the depot";
+        if (drone.size() > instance.numDrone) {
+            error << "the solution uses " << drone.size() << " drones, the instance has " << instance.numDrone;
+            return error.str();
+        }
+
+        vector<bool> seen(instance.numPoint+1, false);
+        FOR(i, 1, vehicle.size()-2) {
+            int x = vehicle[i];
+            if (x <= 0 || x > instance.numPoint) { error << "customer " << x << " does not exist"; return error.str(); }
+            if (seen[x]) { error << "customer " << x << " is visited twice"; return error.str(); }
+            seen[x] = true;
+        }
+        for (const vector<int> &vec : drone.node) for (int x : vec) {
+            if (x <= 0 || x > instance.numPoint) { error << "customer " << x << " does not exist"; return error.str(); }
+            if (instance.drone_cost[x] <= 1e-9) { error << "customer " << x << " is not drone eligible"; return error.str(); }
+            if (seen[x]) { error << "customer " << x << " is visited twice"; return error.str(); }
+            seen[x] = true;
+        }
+        FOR(x, 1, instance.numPoint) if (!seen[x]) { error << "customer " << x << " is missing"; return error.str(); }
+
+        while (drone.size() < instance.numDrone) drone.add_drone();
+        return "";
+    }
+}
+
+#endif
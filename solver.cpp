@@ -0,0 +1,84 @@
+#ifndef PDSTSP_SOLVER
+#define PDSTSP_SOLVER
+
+#include "template.cpp"
+#include "point.cpp"
+#include "problem.cpp"
+#include "paper_Input_adaptation.cpp"
+#include "ACO_solution.cpp"
+#include "rng.cpp"
+
+/*
+ * Self-contained solver: owns its instance, parameters, random stream and result.
+ * solve() touches no global state, so different Solver objects can be solved
+ * concurrently, one per thread. Solve #k of a Solver seeded with s draws the same
+ * random stream as run #k of `winter_main --seed s`.
+ */
+class Solver
+{
+public:
+    tigersugar::Instance instance;
+    ACO_solution::Parameters parameters;
+    ACO_solution::Initial_Solution initial;
+    Convergence_Trace::Writer *trace = NULL; // optional, owned by the caller
+
+    Solver(const tigersugar::Instance &_instance, uint64_t _seed = 1)
+        : instance(_instance), parameters(ACO_solution::default_parameters(_instance)), seed(_seed), run(0) {}
+
+    /// instance file in the data/ format, returns false if the file can not be read
+    static bool load(const string &input_file, int numCustomer, int numDrone, double vSpeed, double dSpeed,
+                     tigersugar::Instance &instance) {
+        vector<Point::point> points;
+        vector<bool> drone_eligible;
+        if (!Problem::read_points(input_file, numCustomer, points, drone_eligible)) return false;
+        instance = Input_Adaptation::Build(points, drone_eligible, numDrone, vSpeed, dSpeed);
+        return true;
+    }
+
+    void set_time_limit(double seconds) {
+        instance.time_limit = parameters.tLimit = seconds;
+    }
+
+    void set_loop_limit(int loops) {
+        instance.loop_limit = parameters.iLimit = loops;
+    }
+
+    void set_initial_solution(const tigersugar::Tour &vehicle, const tigersugar::Drone_Tour &drone, double bias) {
+        initial.enabled = true;
+        initial.vehicle = vehicle;
+        initial.drone = drone;
+        initial.bias = bias;
+    }
+
+    /// one run of the colony on the calling thread, the thread's own generator is left untouched
+    const ACO_solution::Result &solve() {
+        ++run;
+        Rng::Xoshiro256 saved = Rng::solver;
+        Rng::seed_stream(seed, run);
+
+        ACO_solution::Context context;
+        context.param = parameters;
+        context.initial = &initial;
+        context.trace = trace;
+        if (trace != NULL) trace->run = run;
+
+        res = ACO_solution::solve(instance, context);
+        Rng::solver = saved;
+        return res;
+    }
+
+    const ACO_solution::Result &result() const {
+        return res;
+    }
+
+    int runs() const {
+        return run;
+    }
+
+private:
+    uint64_t seed;
+    int run;
+    ACO_solution::Result res;
+};
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef PDSTSP_STAGNATION
+#define PDSTSP_STAGNATION
+
+#include "paper/utilities.cpp"
+
+/*
+ * Convergence measures of the colony.
+ *  - lambda-branching factor of tsp_phe: average number of edges per node whose pheromone is
+ *    at least min + lambda (max - min) of the node's row. Tends to 2 once the colony converged.
+ *  - diversity: average fraction of the ants' vehicle edges that are not in the incumbent tour.
+ */
+namespace Stagnation
+{
+    const double LAMBDA = 0.05;
+
+    double branching_factor(const vector<vector<double> > &tsp_phe, double lambda = LAMBDA) {
+        int n = tsp_phe.size(), rows = 0;
+        double sum = 0;
+        REP(u, n) {
+            double lo = 1e18, hi = -1e18;
+            REP(v, n) if (v != u && tsp_phe[u][v] >= 0) { lo = min(lo, tsp_phe[u][v]); hi = max(hi, tsp_phe[u][v]); }
+            if (hi - lo <= 1e-12 * max(1.0, hi)) continue; /// no preference: node off the vehicle tours
+            double threshold = lo + lambda * (hi - lo);
+            int cnt = 0;
+            REP(v, n) if (v != u && tsp_phe[u][v] >= threshold) ++cnt;
+            sum += cnt;
+            ++rows;
+        }
+        return rows ? sum / rows : 0;
+    }
+
+    /// undirected edges of a tour, for the diversity measure
+    struct Edge_Set {
+        vector<int> next, prev;
+
+        void assign(const tigersugar::Tour &tour, int numPoint) {
+            next.assign(numPoint + 1, -1);
+            prev.assign(numPoint + 1, -1);
+            FOR(i, 0, tour.size() - 2) {
+                next[tour[i]] = tour[i+1];
+                prev[tour[i+1]] = tour[i];
+            }
+        }
+
+        bool contains(int u, int v) const {
+            return next[u] == v || prev[u] == v;
+        }
+
+        /// fraction of the edges of tour that are not in the set
+        double distance(const tigersugar::Tour &tour) const {
+            int edges = tour.size() - 1, diff = 0;
+            if (edges <= 0) return 0;
+            FOR(i, 0, edges - 1) if (!contains(tour[i], tour[i+1])) ++diff;
+            return (double) diff / edges;
+        }
+    };
+}
+
+#endif
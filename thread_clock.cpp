@@ -0,0 +1,22 @@
+#ifndef PDSTSP_THREAD_CLOCK
+#define PDSTSP_THREAD_CLOCK
+
+#include "paper/utilities.cpp"
+
+/*
+ * The clock of every time limit of a solve: CPU time of the calling thread, so concurrent solves
+ * (daemon workers) do not eat each other's time limit. Falls back to clock() without a thread
+ * CPU clock.
+ */
+namespace Thread_Clock
+{
+    double cpu_time() {
+    #ifdef CLOCK_THREAD_CPUTIME_ID
+        timespec ts;
+        if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) == 0) return ts.tv_sec + ts.tv_nsec * 1e-9;
+    #endif
+        return (double) clock() / CLOCKS_PER_SEC;
+    }
+}
+
+#endif
@@ -1,3 +1,6 @@
+#ifndef PDSTSP_VALIDATOR
+#define PDSTSP_VALIDATOR
+
 #include "problem.cpp"
 
 namespace winter_validator {
@@ -80,4 +83,6 @@ namespace winter_validator {
 
         exit(1);
     }
-}
\ No newline at end of file
+}
+
+#endif
@@ -3,8 +3,11 @@
 #include "problem.cpp"
 #include "validator.cpp"
 #include "paper_Input_adaptation.cpp"
+#include "solution_reader.cpp"
+#include "renumber.cpp"
 
 #include "ACO_solution.cpp"
+#include "daemon.cpp"
 
 int main(int argc, char *argv[])
 {
@@ -13,6 +16,21 @@ int main(int argc, char *argv[])
     cout.tie(0);
 
     Config::parse_arguments(argc, argv);
+    Logger::start(Config::log_level);
+    ACO_solution::options.exact_limit = Config::exact_limit;
+    ACO_solution::options.gap = Config::gap;
+    ACO_solution::options.stagnation_stop = Config::stagnation_stop;
+    ACO_solution::options.restart = Config::restart;
+    ACO_solution::options.restart_branching = Config::restart_branching;
+    ACO_solution::options.adaptive = Config::adaptive;
+    ACO_solution::options.memo_cache = Config::memo_cache;
+    ACO_solution::options.pms_improve = Config::pms_improve;
+    ACO_solution::options.granular = Config::granular;
+
+    if (Config::daemon) {
+        Daemon::serve(Config::workers);
+        return 0;
+    }
 
     Problem::import_data_from_tsplib_instance(
         Config::input,
@@ -25,34 +43,82 @@ int main(int argc, char *argv[])
         Config::output 
     );
 
-    freopen(Problem::output.c_str(), "w", stdout);
+    tigersugar::Instance instance = Input_Adaptation::Process();
+    Renumber::Permutation renumbering = Renumber::build(Config::renumber, Problem::points);
+
+    if (Config::found_initial_solution) {
+        Solution_Reader::Solution initial;
+        if (!Solution_Reader::read(Config::initial_solution, initial)) {
+            LOG_ERROR("No solution found in " << Config::initial_solution);
+            exit(0);
+        }
+        string error = Solution_Reader::validate(instance, initial);
+        if (!error.empty()) {
+            LOG_ERROR("Invalid initial solution: " << error);
+            exit(0);
+        }
+        renumbering.to_internal(initial.vehicle.points);
+        for (vector<int> &x : initial.drone.node) renumbering.to_internal(x);
+        ACO_solution::set_initial_solution(initial.vehicle, initial.drone, Config::initial_bias);
+    }
+
+    /// the solver runs on the renumbered instance, the initial solution is checked against the file ids
+    instance = renumbering.apply(instance);
+
+    /// continue a preempted job from its checkpoint
+    int first_run = 1;
+    bool resumed = false;
+    if (Config::found_checkpoint) {
+        Checkpoint::file = Config::checkpoint;
+        Checkpoint::interval = Config::checkpoint_interval;
+
+        Checkpoint::Header &header = Checkpoint::header;
+        vector<bool> drone_eligible;
+        for (double x : Problem::dCost) drone_eligible.push_back(x != Constant::INF);
+        header.numPoint = instance.numPoint;
+        header.numDrone = Problem::m;
+        header.vehicle_speed = Problem::vehicle_speed;
+        header.drone_speed = Problem::drone_speed;
+        header.renumber = (Config::renumber == "hilbert");
+        header.instance = Checkpoint::instance_hash(Problem::points, drone_eligible);
+
+        if (Config::resume && Checkpoint::load()) {
+            first_run = Checkpoint::run;
+            resumed = true;
+            LOG_INFO("Resume from checkpoint " << Config::checkpoint << " at run #" << first_run);
+        }
+    }
+
+    freopen(Problem::output.c_str(), resumed ? "a" : "w", stdout);
     string sat_file = Problem::output + ".sat";
-    ofstream sat(sat_file);
+    ofstream sat(sat_file, resumed ? ios::app : ios::out);
 
-    tigersugar::Instance instance = Input_Adaptation::Process();
+    if (Config::found_trace) Convergence_Trace::trace.open(Config::trace, resumed);
 
-    double avgRes = 0, avgTime = 0, avgLoop = 0, maxRes = -1, minRes = -1;
-    FOR(Time, 1, 10) {
-    	cerr<<Time<<"\n";
+    Checkpoint::Summary &summary = Checkpoint::summary;
+    double avgRes = summary.sum_result, avgTime = summary.sum_time, avgLoop = summary.sum_loop;
+    double maxRes = summary.max_result, minRes = summary.min_result;
+    FOR(Time, first_run, Config::runs) {
+    	LOG_INFO("Run #" << Time);
+        Convergence_Trace::trace.run = Time;
+        Checkpoint::run = Time;
+        Rng::seed_stream(Config::seed, Time);
         ACO_solution::process(instance);
+        renumbering.to_original(Problem::vTour);
+        for (vector<int> &x : Problem::dTour) renumbering.to_original(x);
+
+        LOG_INFO("RESULT: " << Problem::result);
+        if (Logger::LEVEL_DEBUG <= Logger::max_level) {
+            ostringstream vehicle_tour;
+            for (int x : Problem::vTour) vehicle_tour << x << " ";
+            LOG_DEBUG("VEHICLE TOUR: " << vehicle_tour.str());
 
-        cerr << "Number of customers: " << Problem::n << "\n";
-        cerr << "Number of drones: " << Problem::m << "\n";
-        cerr << "Number of drone_eligible: " << Problem::nD-1 << "\n\n";
-        
-            cerr << "RESULT: " << Problem::result << "\n\n";
-            
-            cerr << "VEHICLE TOUR: ";
-            for (int x : Problem::vTour) cerr << x << " ";
-            cerr << "\n\n";
-            
-            cerr << "DRONE TOUR:\n";
             for (int i = 0; i < (int) Problem::dTour.size(); ++i) {
-                cerr << "drone " << i+1 << ": ";
-                for (int x : Problem::dTour[i]) cerr << x << " ";
-                cerr << '\n';
+                ostringstream drone_tour;
+                for (int x : Problem::dTour[i]) drone_tour << x << " ";
+                LOG_DEBUG("drone " << i+1 << ": " << drone_tour.str());
             }
-            cerr << '\n';
+        }
 
         cout << "Number of customers: " << Problem::n << "\n";
         cout << "Number of drones: " << Problem::m << "\n";
@@ -76,21 +142,35 @@ int main(int argc, char *argv[])
 
         sat << Problem::result << " " << Problem::excutionTime << " " << Problem::numOutLoop << endl;
         
-        minRes = (Time == 1) ? Problem::result : min(minRes, Problem::result);
-        maxRes = (Time == 1) ? Problem::result : max(maxRes, Problem::result);
+        minRes = (minRes < 0) ? Problem::result : min(minRes, Problem::result);
+        maxRes = (maxRes < 0) ? Problem::result : max(maxRes, Problem::result);
         
         avgRes += Problem::result;
         avgTime += Problem::excutionTime;
         avgLoop += Problem::numOutLoop;
+
+        if (Checkpoint::enabled()) {
+            summary.finished_runs = Time;
+            summary.sum_result = avgRes;
+            summary.sum_time = avgTime;
+            summary.sum_loop = avgLoop;
+            summary.min_result = minRes;
+            summary.max_result = maxRes;
+            Checkpoint::run = Time + 1;
+            Convergence_Trace::trace.flush();
+            Checkpoint::save_summary();
+        }
     }
 
-    cerr <<"\nbest-cost\t\tavg-cost\t\tavg-time\t\tworst-cost\t\tavg-loop\n";
-    cerr << minRes << "\t\t\t" << avgRes/10 << "\t\t\t" << avgTime/10 << "\t\t\t" << maxRes << "\t\t\t" << avgLoop/10 << '\n'; 
+    Convergence_Trace::trace.close();
+
+    LOG_INFO("best-cost " << minRes << " avg-cost " << avgRes/Config::runs << " avg-time " << avgTime/Config::runs
+             << " worst-cost " << maxRes << " avg-loop " << avgLoop/Config::runs);
 
     sat <<"\nbest-cost\t\tavg-cost\t\tavg-time\t\tworst\t\tavg-loop\n";
-    sat << minRes << "\t\t\t" << avgRes/10 << "\t\t\t" << avgTime/10 << "\t\t\t" << maxRes << "\t\t\t" << avgLoop/10 << '\n';  
+    sat << minRes << "\t\t\t" << avgRes/Config::runs << "\t\t\t" << avgTime/Config::runs << "\t\t\t" << maxRes << "\t\t\t" << avgLoop/Config::runs << '\n';  
 
     cout <<"\nbest-cost\t\tavg-cost\t\tavg-time\t\tworst-cost\t\tavg-loop\n";
-    cout << minRes << "\t\t\t" << avgRes/10 << "\t\t\t" << avgTime/10 << "\t\t\t" << maxRes << "\t\t\t" << avgLoop/10 << '\n';      
+    cout << minRes << "\t\t\t" << avgRes/Config::runs << "\t\t\t" << avgTime/Config::runs << "\t\t\t" << maxRes << "\t\t\t" << avgLoop/Config::runs << '\n';      
 
 }